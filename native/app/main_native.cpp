@@ -0,0 +1,82 @@
+// Execução de verificação do ambiente [env:native] (pio run -e native && .pio/build/native/program):
+// monta o LittleFS no host, faz o mesmo setup() do firmware, corre o agendador durante
+// alguns segundos e mostra os registos gravados e as notificações BLE de cada sensor.
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <filesystem>
+#include "native_env.h"
+#include "../../src/ble_handler.h"
+#include "../../src/data_logger.h"
+#include "../../src/device_controller.h"
+#include "../../src/hub_config.h"
+#include "../../src/wifi_handler.h"
+
+// Duração padrão da execução (NATIVE_SMOKE_MS substitui)
+#define NATIVE_SMOKE_DEFAULT_MS 3000UL
+
+// Equivalente ao "pio run -t uploadfs": na primeira execução copia a pasta data/ para a raiz
+static void seedFileSystem() {
+    namespace stdfs = std::filesystem;
+    const char* dataDir = getenv("NATIVE_DATA_DIR");
+    stdfs::path source = (dataDir && dataDir[0]) ? dataDir : "data";
+    stdfs::path root = LittleFS.hostRoot();
+
+    std::error_code ec;
+    if (!stdfs::is_directory(source, ec) || !stdfs::is_empty(root, ec)) return;
+
+    stdfs::copy(source, root, stdfs::copy_options::recursive, ec);
+    if (ec) Serial.printf("⚠️ Falha ao copiar %s: %s\n", source.c_str(), ec.message().c_str());
+    else Serial.printf("📁 %s copiado para %s\n", source.c_str(), root.c_str());
+}
+
+// Globais que o ble_handler espera do main.cpp
+DeviceController meuDevice;
+bool isSystemReady = false;
+
+int main() {
+    Serial.println("\nIniciando Sensor Hub (native)...");
+
+    if (!LittleFS.begin(true)) {
+        Serial.println("Falha ao montar o LittleFS.");
+        return 1;
+    }
+    seedFileSystem();
+
+    HubConfig::getInstance().load();
+
+    if (!meuDevice.init()) {
+        Serial.println("\n!!! ERRO FATAL: Falha na inicialização do DeviceController. !!!");
+        return 1;
+    }
+    isSystemReady = true;
+    setupDataLogger();
+    setupBLE(meuDevice);
+    setupWiFi(meuDevice);
+
+    const char* smokeMs = getenv("NATIVE_SMOKE_MS");
+    unsigned long duration = (smokeMs && smokeMs[0]) ? strtoul(smokeMs, nullptr, 10) : NATIVE_SMOKE_DEFAULT_MS;
+
+    // Mesmo ciclo do loop() do firmware
+    unsigned long start = millis();
+    while (millis() - start < duration) {
+        unsigned long sleepMs = min(meuDevice.runScheduler(), 100UL);
+        loopDataLogger();
+        loopBLE(meuDevice);
+        if (sleepMs > 0) delay(sleepMs);
+    }
+    flushLogs();
+
+    Serial.println("\n======================================");
+    Serial.printf(" Registos no manifesto: %u\n", (unsigned)getTotalRecordCount());
+    for (Sensor* sensor : meuDevice.getSensors()) {
+        BLECharacteristic* characteristic = nativeFindCharacteristic(sensor->getCharacteristicUuid().c_str());
+        if (!characteristic) continue;
+        Serial.printf(" %-12s notificações: %u (%u bytes)\n", sensor->getSensorId().c_str(),
+                      (unsigned)characteristic->notifyCount(), (unsigned)characteristic->notifiedBytes());
+    }
+    Serial.printf(" LittleFS: %u de %u bytes usados em %s\n", (unsigned)LittleFS.usedBytes(),
+                  (unsigned)LittleFS.totalBytes(), LittleFS.hostRoot());
+    Serial.println("======================================");
+    return 0;
+}
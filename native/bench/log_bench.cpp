@@ -0,0 +1,460 @@
+// Benchmark do logger (pio run -e native_bench && .pio/build/native_bench/program [opções]):
+// gera árvores de logs sintéticas com generateTestLogs() e mede, para cada combinação de
+// dias × sensores, a gravação, a contagem, a exportação (stream, /historico e /historico/stream em chunks),
+// o sync BLE e a compactação dos dias fechados. O resultado sai em JSON (stdout ou --out) para comparar versões do firmware.
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+#include <LittleFS.h>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include "native_env.h"
+#include "../../src/ble_handler.h"
+#include "../../src/data_logger.h"
+#include "../../src/device_controller.h"
+#include "../../src/hub_config.h"
+#include "../../src/log_generator.h"
+#include "../../src/wifi_handler.h"
+
+// Características do serviço HUB (protocolo do ble_handler)
+#define BENCH_HUB_RX_UUID "beb5483e-36e1-4688-b7f5-ea07361b26a8"
+#define BENCH_HUB_TX_UUID "f48ebb2c-442a-4732-b0b3-009758a2f9b1"
+
+// 1 de janeiro de 2025, 00:00 UTC: cada dia gerado começa à meia-noite
+#define BENCH_START_TS 1735689600
+#define BENCH_SYNC_TIMEOUT_MS 120000UL
+
+// Globais que o ble_handler espera do main.cpp
+DeviceController meuDevice;
+bool isSystemReady = false;
+
+// Servidor do wifi_handler, alimentado com pedidos simulados
+extern AsyncWebServer server;
+
+struct BenchOptions {
+    std::vector<uint32_t> days = {1, 7};
+    std::vector<uint32_t> sensors = {1, 5};
+    uint32_t recordsPerDay = 288; // por sensor: uma leitura a cada 5 minutos
+    String format = "jsonl";
+    String compress = "columnar"; // compactação dos dias fechados
+    uint16_t mtu = 247;
+    size_t chunk = 1436;          // maxLen típico de um chunk do AsyncTCP
+    String label = "dev";
+    String out;
+};
+
+static void printUsage(const char* program) {
+    fprintf(stderr,
+            "Uso: %s [--days 1,7] [--sensors 1,5] [--records 288] [--format jsonl|binary]\n"
+            "          [--compress columnar|gzip] [--mtu 247] [--chunk 1436] [--label versão] [--out resultado.json]\n",
+            program);
+}
+
+static bool parseList(const char* text, std::vector<uint32_t>& values) {
+    values.clear();
+    String list(text);
+    int start = 0;
+    while (start <= (int)list.length()) {
+        int comma = list.indexOf(',', start);
+        String item = list.substring(start, comma == -1 ? list.length() : comma);
+        long value = item.toInt();
+        if (value <= 0) return false;
+        values.push_back((uint32_t)value);
+        if (comma == -1) break;
+        start = comma + 1;
+    }
+    return !values.empty();
+}
+
+static bool parseOptions(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        String arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+
+        if (arg == "--days") {
+            if (!parseList(value, options.days)) return false;
+        } else if (arg == "--sensors") {
+            if (!parseList(value, options.sensors)) return false;
+        } else if (arg == "--records") {
+            options.recordsPerDay = strtoul(value, nullptr, 10);
+            if (options.recordsPerDay == 0) return false;
+        } else if (arg == "--format") {
+            options.format = value;
+            if (options.format != "jsonl" && options.format != "binary") return false;
+        } else if (arg == "--compress") {
+            options.compress = value;
+            if (options.compress != "columnar" && options.compress != "gzip") return false;
+        } else if (arg == "--mtu") {
+            options.mtu = (uint16_t)constrain(strtoul(value, nullptr, 10), 23UL, 517UL);
+        } else if (arg == "--chunk") {
+            options.chunk = strtoul(value, nullptr, 10);
+            if (options.chunk < 64) return false;
+        } else if (arg == "--label") {
+            options.label = value;
+        } else if (arg == "--out") {
+            options.out = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Copia a configuração de data/ (sem os logs de exemplo) e grava o formato e a compactação pedidos
+static void seedConfig(const String& format, const String& compress) {
+    namespace stdfs = std::filesystem;
+    const char* dataDir = getenv("NATIVE_DATA_DIR");
+    stdfs::path source = (dataDir && dataDir[0]) ? dataDir : "data";
+
+    std::error_code ec;
+    for (const auto& entry : stdfs::directory_iterator(source, ec)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".json") continue;
+        stdfs::copy_file(entry.path(), stdfs::path(LittleFS.hostRoot()) / entry.path().filename(),
+                         stdfs::copy_options::overwrite_existing, ec);
+    }
+
+    DynamicJsonDocument doc(1024);
+    File in = LittleFS.open("/hub_config.json", "r");
+    if (in) {
+        deserializeJson(doc, in);
+        in.close();
+    }
+    doc["log"]["format"] = format;
+    doc["log"]["compress"] = compress;
+    File out = LittleFS.open("/hub_config.json", "w");
+    if (out) {
+        serializeJson(doc, out);
+        out.close();
+    }
+}
+
+// Sensores sintéticos: os tipos do hub repetidos até 'count'
+static std::vector<TestLogSensor> benchSensors(uint32_t count) {
+    static const char* types[][2] = {
+        {"pressure", "bar"}, {"tds_sensor", "ppm"}, {"temperature", "C"}, {"flow", "L/min"}, {"volume", "L"}
+    };
+    std::vector<TestLogSensor> sensors;
+    for (uint32_t i = 0; i < count; i++) {
+        char id[16];
+        snprintf(id, sizeof(id), "bench_%02u", (unsigned)(i + 1));
+        sensors.push_back({id, types[i % 5][0], types[i % 5][1], nullptr});
+    }
+    return sensors;
+}
+
+static uint32_t countRecordsIn(const std::string& body) {
+    uint32_t count = 0;
+    for (size_t pos = body.find("\"ts\":\""); pos != std::string::npos; pos = body.find("\"ts\":\"", pos + 6)) {
+        count++;
+    }
+    return count;
+}
+
+static void setRate(JsonObject obj, uint32_t records, unsigned long elapsedUs) {
+    obj["records"] = records;
+    obj["seconds"] = elapsedUs / 1e6;
+    obj["records_per_s"] = elapsedUs > 0 ? records * 1e6 / elapsedUs : 0.0;
+}
+
+// --- Exportação ---
+
+static void benchStreamExport(JsonObject result, size_t chunk) {
+    std::vector<uint8_t> buffer(chunk);
+    std::string body;
+    size_t chunks = 0;
+
+    unsigned long start = micros();
+    prepareLogStream();
+    while (true) {
+        size_t len = readLogStreamChunk(buffer.data(), buffer.size());
+        if (len == 0) break;
+        body.append((const char*)buffer.data(), len);
+        chunks++;
+    }
+    unsigned long elapsed = micros() - start;
+
+    setRate(result, countRecordsIn(body), elapsed);
+    result["bytes"] = body.size();
+    result["chunks"] = chunks;
+}
+
+static void benchHttpExport(JsonObject result, size_t chunk) {
+    std::string body;
+    uint64_t bytes = 0;
+    size_t callbacks = 0;
+    uint32_t records = 0;
+    uint32_t pages = 0;
+
+    unsigned long start = micros();
+    for (int page = 1;; page++) {
+        AsyncWebServerRequest request(HTTP_GET, "/historico");
+        request.addParam("page", String(page));
+        server.handle(&request);
+        if (!request.response() || request.response()->code() != 200) break;
+
+        size_t calls = 0;
+        body.clear();
+        bytes += pumpResponse(request.response(), &body, chunk, &calls);
+        callbacks += calls;
+        records += countRecordsIn(body);
+        pages++;
+    }
+    unsigned long elapsed = micros() - start;
+
+    setRate(result, records, elapsed);
+    result["bytes"] = bytes;
+    result["pages"] = pages;
+    result["callbacks"] = callbacks;
+}
+
+static void benchHttpStream(JsonObject result, size_t chunk) {
+    std::string body;
+    size_t callbacks = 0;
+
+    unsigned long start = micros();
+    AsyncWebServerRequest request(HTTP_GET, "/historico/stream");
+    server.handle(&request);
+    if (request.response() && request.response()->code() == 200) {
+        pumpResponse(request.response(), &body, chunk, &callbacks);
+    }
+    unsigned long elapsed = micros() - start;
+
+    setRate(result, countRecordsIn(body), elapsed);
+    result["bytes"] = body.size();
+    result["callbacks"] = callbacks;
+}
+
+// --- Sync BLE ---
+
+/**
+ * @brief Cliente BLE simulado: responde ao SOT e confirma os registos como o app,
+ * com ACK de 1 byte por registo (legado) ou ACK cumulativo por notificação (janela).
+ */
+class BenchSyncClient {
+public:
+    explicit BenchSyncClient(bool windowed)
+        : records(0), notifications(0), bytes(0), _windowed(windowed), _sotSeen(false),
+          _contiguous(0), _lastAcked(0), _done(false) {}
+
+    void onNotify(const uint8_t* data, size_t len) {
+        notifications++;
+        bytes += len;
+
+        if (!_sotSeen) {
+            if (std::string((const char*)data, len).find("\"SOT\"") == std::string::npos) return;
+            _sotSeen = true;
+            _ack(0);
+            return;
+        }
+
+        if (!_windowed) {
+            _handleRecord(std::string((const char*)data, len));
+            if (!_isDone()) _ack(0);
+            return;
+        }
+
+        // Frames [uint16 LE comprimento][payload] podem atravessar notificações
+        _frames.append((const char*)data, len);
+        size_t pos = 0;
+        while (_frames.size() - pos >= 2) {
+            size_t frameLen = (uint8_t)_frames[pos] | ((size_t)(uint8_t)_frames[pos + 1] << 8);
+            if (_frames.size() - pos - 2 < frameLen) break;
+            _handleRecord(_frames.substr(pos + 2, frameLen));
+            pos += 2 + frameLen;
+        }
+        _frames.erase(0, pos);
+        if (!_isDone() && _contiguous > _lastAcked) _ack(_contiguous);
+    }
+
+    bool waitDone(unsigned long timeoutMs) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return _cv.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() { return _done; });
+    }
+
+    uint32_t records;
+    uint32_t notifications;
+    uint64_t bytes;
+
+private:
+    void _handleRecord(const std::string& payload) {
+        if (payload.find("\"EOT\"") != std::string::npos) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _done = true;
+            _cv.notify_all();
+            return;
+        }
+        size_t seqPos = payload.find("\"seq\":");
+        if (seqPos == std::string::npos) return;
+        uint32_t seq = strtoul(payload.c_str() + seqPos + 6, nullptr, 10);
+        // Retransmissões não contam duas vezes
+        if (seq == _contiguous + 1) {
+            _contiguous = seq;
+            records++;
+        }
+    }
+
+    bool _isDone() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _done;
+    }
+
+    void _ack(uint32_t seq) {
+        if (_windowed) {
+            uint8_t msg[5] = {0x01, (uint8_t)seq, (uint8_t)(seq >> 8), (uint8_t)(seq >> 16), (uint8_t)(seq >> 24)};
+            _lastAcked = seq;
+            nativeBleWrite(BENCH_HUB_RX_UUID, msg, sizeof(msg));
+        } else {
+            uint8_t msg = 0x01;
+            nativeBleWrite(BENCH_HUB_RX_UUID, &msg, 1);
+        }
+    }
+
+    bool _windowed;
+    bool _sotSeen;
+    std::string _frames;
+    uint32_t _contiguous;
+    uint32_t _lastAcked;
+    bool _done;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+};
+
+// Sync completo (0x02 + since 0) ou só o que falta confirmar desde o último (0x02)
+static void benchBleSync(JsonObject result, bool windowed, uint16_t mtu, bool delta = false) {
+    BLECharacteristic* tx = nativeFindCharacteristic(BENCH_HUB_TX_UUID);
+    if (!tx) {
+        result["skipped"] = "BLE não iniciado (DeviceController sem sensores)";
+        return;
+    }
+
+    BenchSyncClient client(windowed);
+    tx->setNotifyListener([&client](const uint8_t* data, size_t len) { client.onNotify(data, len); });
+    nativeBleConnect(mtu);
+
+    unsigned long start = micros();
+    const uint8_t command[5] = {0x02, 0, 0, 0, 0};
+    nativeBleWrite(BENCH_HUB_RX_UUID, command, delta ? 1 : sizeof(command));
+    bool completed = client.waitDone(BENCH_SYNC_TIMEOUT_MS);
+    unsigned long elapsed = micros() - start;
+
+    nativeBleDisconnect();
+    delay(10); // deixa a tarefa de sync voltar à espera antes de trocar o ouvinte
+    tx->setNotifyListener(nullptr);
+
+    setRate(result, client.records, elapsed);
+    result["completed"] = completed;
+    result["mtu"] = mtu;
+    result["notifications"] = client.notifications;
+    result["bytes"] = client.bytes;
+}
+
+// --- Execução ---
+
+static void runCombination(JsonObject result, const BenchOptions& options, uint32_t days, uint32_t sensorCount) {
+    deleteLogFiles();
+
+    std::vector<TestLogSensor> sensors = benchSensors(sensorCount);
+    for (const TestLogSensor& s : sensors) registerLogSensor(s.sensorId);
+
+    // Espaça os registos para que cada dia receba 'recordsPerDay' leituras de cada sensor
+    uint32_t step = 86400UL / (options.recordsPerDay * sensorCount);
+    if (step == 0) step = 1;
+    uint32_t cycles = days * options.recordsPerDay;
+
+    result["days"] = days;
+    result["sensors"] = sensorCount;
+
+    unsigned long start = micros();
+    uint32_t generated = generateTestLogs(sensors, BENCH_START_TS, cycles, step);
+    flushLogs();
+    setRate(result.createNestedObject("append"), generated, micros() - start);
+    result["records"] = generated;
+    result["log_bytes"] = LittleFS.usedBytes();
+
+    start = micros();
+    int scanned = getTotalRecordsInAllFiles();
+    setRate(result.createNestedObject("count_scan"), scanned, micros() - start);
+
+    // Meio dia após o meio do período: corta um dia ao meio e usa o índice
+    time_t since = BENCH_START_TS + (days / 2) * 86400UL + 43200UL;
+    start = micros();
+    uint32_t inRange = countRecordsInRange(since, 0);
+    setRate(result.createNestedObject("count_range"), inRange, micros() - start);
+
+    benchStreamExport(result.createNestedObject("stream_export"), options.chunk);
+    benchHttpExport(result.createNestedObject("http_export"), options.chunk);
+    benchHttpStream(result.createNestedObject("http_stream"), options.chunk);
+    benchBleSync(result.createNestedObject("ble_sync_legacy"), false, options.mtu);
+    benchBleSync(result.createNestedObject("ble_sync_windowed"), true, options.mtu);
+    benchBleSync(result.createNestedObject("ble_sync_delta"), true, options.mtu, true); // nada de novo desde o anterior
+
+    // Todos os dias menos o último ficam fechados: compacta-os e volta a ler já descomprimindo
+    JsonObject compaction = result.createNestedObject("compaction");
+    start = micros();
+    compaction["files"] = compactClosedLogFiles();
+    compaction["seconds"] = (micros() - start) / 1e6;
+    compaction["log_bytes"] = LittleFS.usedBytes(); // blocos de 4 KB: ficheiros pequenos arredondam
+    uint32_t fileBytes = 0;
+    LogCatalogEntry entry;
+    for (size_t i = 0; getLogCatalogEntry(i, entry); i++) fileBytes += entry.bytes;
+    compaction["file_bytes"] = fileBytes;
+
+    benchStreamExport(result.createNestedObject("stream_export_compressed"), options.chunk);
+    benchBleSync(result.createNestedObject("ble_sync_windowed_compressed"), true, options.mtu);
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    // As mensagens do firmware não se misturam com o JSON
+    Serial.setQuiet(true);
+
+    if (!LittleFS.begin(true)) {
+        fprintf(stderr, "Falha ao montar o LittleFS em %s\n", LittleFS.hostRoot());
+        return 1;
+    }
+    seedConfig(options.format, options.compress);
+    HubConfig::getInstance().load();
+    isSystemReady = meuDevice.init();
+    setupDataLogger();
+    if (isSystemReady) setupBLE(meuDevice);
+    setupWiFi(meuDevice);
+
+    size_t combinations = options.days.size() * options.sensors.size();
+    DynamicJsonDocument doc(4096 + combinations * 4096);
+    doc["bench"] = "log_bench";
+    doc["label"] = options.label;
+    doc["format"] = options.format;
+    doc["compress"] = options.compress;
+    doc["records_per_day"] = options.recordsPerDay;
+    doc["http_chunk"] = options.chunk;
+    JsonArray results = doc.createNestedArray("results");
+
+    for (uint32_t days : options.days) {
+        for (uint32_t sensorCount : options.sensors) {
+            fprintf(stderr, "▶ %u dia(s) × %u sensor(es)...\n", (unsigned)days, (unsigned)sensorCount);
+            runCombination(results.createNestedObject(), options, days, sensorCount);
+        }
+    }
+    deleteLogFiles();
+
+    String output;
+    serializeJsonPretty(doc, output);
+    output += '\n';
+
+    FILE* out = options.out.length() > 0 ? fopen(options.out.c_str(), "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Falha ao abrir %s\n", options.out.c_str());
+        return 1;
+    }
+    fwrite(output.c_str(), 1, output.length(), out);
+    if (out != stdout) fclose(out);
+    return 0;
+}
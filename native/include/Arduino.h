@@ -0,0 +1,361 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// Substituto do core Arduino-ESP32 para o ambiente [env:native] (ver native/README.md).
+// Só cobre o que o firmware usa; o comportamento segue o do core 2.x.
+
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <math.h>
+#include <ctime>
+#include <cstdarg>
+#include <algorithm>
+#include <vector>
+#include <functional>
+#include <sys/time.h>
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define F(x) x
+#define PROGMEM
+#define IRAM_ATTR
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define HIGH 0x1
+#define LOW 0x0
+
+// --- String ---
+
+class String {
+public:
+    String(const char* cstr = "") : _s(cstr ? cstr : "") {}
+    String(const std::string& s) : _s(s) {}
+    explicit String(char c) : _s(1, c) {}
+    explicit String(unsigned char v, unsigned char base = 10) : _s(_fromInt(v, base)) {}
+    explicit String(int v, unsigned char base = 10) : _s(_fromInt(v, base)) {}
+    explicit String(unsigned int v, unsigned char base = 10) : _s(_fromInt(v, base)) {}
+    explicit String(long v, unsigned char base = 10) : _s(_fromInt(v, base)) {}
+    explicit String(unsigned long v, unsigned char base = 10) : _s(_fromInt(v, base)) {}
+    explicit String(long long v, unsigned char base = 10) : _s(_fromInt(v, base)) {}
+    explicit String(unsigned long long v, unsigned char base = 10) : _s(_fromInt(v, base)) {}
+    explicit String(float v, unsigned int decimals = 2) : _s(_fromFloat(v, decimals)) {}
+    explicit String(double v, unsigned int decimals = 2) : _s(_fromFloat(v, decimals)) {}
+
+    const char* c_str() const { return _s.c_str(); }
+    unsigned int length() const { return (unsigned int)_s.size(); }
+    bool isEmpty() const { return _s.empty(); }
+    bool reserve(unsigned int size) { _s.reserve(size); return true; }
+
+    // No core Arduino um String válido é sempre "verdadeiro", mesmo vazio
+    explicit operator bool() const { return true; }
+
+    bool concat(const String& s) { _s += s._s; return true; }
+    bool concat(const char* cstr) { if (!cstr) return false; _s += cstr; return true; }
+    bool concat(const char* cstr, unsigned int len) { if (!cstr) return false; _s.append(cstr, len); return true; }
+    bool concat(char c) { _s += c; return true; }
+    bool concat(unsigned char v) { return concat(String(v)); }
+    bool concat(int v) { return concat(String(v)); }
+    bool concat(unsigned int v) { return concat(String(v)); }
+    bool concat(long v) { return concat(String(v)); }
+    bool concat(unsigned long v) { return concat(String(v)); }
+    bool concat(float v) { return concat(String(v)); }
+    bool concat(double v) { return concat(String(v)); }
+
+    template <typename T>
+    String& operator+=(const T& v) { concat(v); return *this; }
+
+    bool equals(const String& s) const { return _s == s._s; }
+    bool equals(const char* cstr) const { return _s == (cstr ? cstr : ""); }
+    bool equalsIgnoreCase(const String& s) const { return strcasecmp(_s.c_str(), s._s.c_str()) == 0; }
+    int compareTo(const String& s) const { return strcmp(_s.c_str(), s._s.c_str()); }
+    bool operator==(const String& s) const { return equals(s); }
+    bool operator==(const char* cstr) const { return equals(cstr); }
+    bool operator!=(const String& s) const { return !equals(s); }
+    bool operator!=(const char* cstr) const { return !equals(cstr); }
+    bool operator<(const String& s) const { return compareTo(s) < 0; }
+    bool operator>(const String& s) const { return compareTo(s) > 0; }
+    bool operator<=(const String& s) const { return compareTo(s) <= 0; }
+    bool operator>=(const String& s) const { return compareTo(s) >= 0; }
+
+    bool startsWith(const String& prefix) const { return _s.compare(0, prefix._s.size(), prefix._s) == 0; }
+    bool startsWith(const String& prefix, unsigned int offset) const {
+        return offset <= _s.size() && _s.compare(offset, prefix._s.size(), prefix._s) == 0;
+    }
+    bool endsWith(const String& suffix) const {
+        return _s.size() >= suffix._s.size() && _s.compare(_s.size() - suffix._s.size(), suffix._s.size(), suffix._s) == 0;
+    }
+
+    char charAt(unsigned int index) const { return index < _s.size() ? _s[index] : 0; }
+    void setCharAt(unsigned int index, char c) { if (index < _s.size()) _s[index] = c; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index) { return _s[index]; }
+    void getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index = 0) const {
+        toCharArray((char*)buf, bufsize, index);
+    }
+    void toCharArray(char* buf, unsigned int bufsize, unsigned int index = 0) const {
+        if (!bufsize || !buf) return;
+        size_t n = index < _s.size() ? std::min<size_t>(bufsize - 1, _s.size() - index) : 0;
+        if (n) memcpy(buf, _s.data() + index, n);
+        buf[n] = '\0';
+    }
+
+    int indexOf(char c, unsigned int from = 0) const { return _pos(_s.find(c, from)); }
+    int indexOf(const String& s, unsigned int from = 0) const { return _pos(_s.find(s._s, from)); }
+    int lastIndexOf(char c) const { return _pos(_s.rfind(c)); }
+    int lastIndexOf(char c, unsigned int from) const { return _pos(_s.rfind(c, from)); }
+    int lastIndexOf(const String& s) const { return _pos(_s.rfind(s._s)); }
+
+    String substring(unsigned int left) const { return left < _s.size() ? String(_s.substr(left)) : String(); }
+    String substring(unsigned int left, unsigned int right) const {
+        if (left > right) std::swap(left, right);
+        if (left >= _s.size()) return String();
+        return String(_s.substr(left, std::min<size_t>(right, _s.size()) - left));
+    }
+
+    void replace(char find, char repl) { std::replace(_s.begin(), _s.end(), find, repl); }
+    void replace(const String& find, const String& repl) {
+        if (find._s.empty()) return;
+        size_t p = 0;
+        while ((p = _s.find(find._s, p)) != std::string::npos) {
+            _s.replace(p, find._s.size(), repl._s);
+            p += repl._s.size();
+        }
+    }
+    void remove(unsigned int index) { if (index < _s.size()) _s.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < _s.size()) _s.erase(index, count); }
+    void toLowerCase() { for (auto& c : _s) c = (char)tolower((unsigned char)c); }
+    void toUpperCase() { for (auto& c : _s) c = (char)toupper((unsigned char)c); }
+    void trim() {
+        size_t a = _s.find_first_not_of(" \t\r\n");
+        if (a == std::string::npos) { _s.clear(); return; }
+        size_t b = _s.find_last_not_of(" \t\r\n");
+        _s = _s.substr(a, b - a + 1);
+    }
+
+    long toInt() const { return atol(_s.c_str()); }
+    float toFloat() const { return (float)atof(_s.c_str()); }
+    double toDouble() const { return atof(_s.c_str()); }
+
+private:
+    static int _pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+
+    template <typename T>
+    static std::string _fromInt(T v, unsigned char base) {
+        if (base == 10) return std::to_string(v);
+        char buf[72];
+        char* p = buf + sizeof(buf) - 1;
+        *p = '\0';
+        bool neg = v < 0;
+        unsigned long long u = neg ? (unsigned long long)(-(long long)v) : (unsigned long long)v;
+        do {
+            unsigned d = u % base;
+            *--p = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+            u /= base;
+        } while (u);
+        if (neg) *--p = '-';
+        return p;
+    }
+
+    static std::string _fromFloat(double v, unsigned int decimals) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+        return buf;
+    }
+
+    std::string _s;
+};
+
+// O ArduinoJson reconhece também o tipo intermédio das concatenações
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const String& s) : String(s) {}
+    StringSumHelper(const char* p) : String(p) {}
+};
+
+inline StringSumHelper operator+(const String& a, const String& b) { StringSumHelper r(a); r.concat(b); return r; }
+inline StringSumHelper operator+(const String& a, const char* b) { StringSumHelper r(a); r.concat(b); return r; }
+inline StringSumHelper operator+(const char* a, const String& b) { StringSumHelper r(a); r.concat(b); return r; }
+inline StringSumHelper operator+(const String& a, char b) { StringSumHelper r(a); r.concat(b); return r; }
+inline StringSumHelper operator+(const String& a, int b) { StringSumHelper r(a); r.concat(b); return r; }
+inline StringSumHelper operator+(const String& a, unsigned int b) { StringSumHelper r(a); r.concat(b); return r; }
+inline StringSumHelper operator+(const String& a, long b) { StringSumHelper r(a); r.concat(b); return r; }
+inline StringSumHelper operator+(const String& a, unsigned long b) { StringSumHelper r(a); r.concat(b); return r; }
+inline StringSumHelper operator+(const String& a, float b) { StringSumHelper r(a); r.concat(b); return r; }
+inline StringSumHelper operator+(const String& a, double b) { StringSumHelper r(a); r.concat(b); return r; }
+
+// --- Print / Stream ---
+
+class Print;
+
+class Printable {
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print& p) const = 0;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+    size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+    size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+
+    size_t print(const String& s) { return write(s.c_str(), s.length()); }
+    size_t print(const Printable& x) { return x.printTo(*this); }
+    size_t print(const char* s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char v, int base = 10) { return print(String(v, (unsigned char)base)); }
+    size_t print(int v, int base = 10) { return print(String(v, (unsigned char)base)); }
+    size_t print(unsigned int v, int base = 10) { return print(String(v, (unsigned char)base)); }
+    size_t print(long v, int base = 10) { return print(String(v, (unsigned char)base)); }
+    size_t print(unsigned long v, int base = 10) { return print(String(v, (unsigned char)base)); }
+    size_t print(long long v, int base = 10) { return print(String(v, (unsigned char)base)); }
+    size_t print(unsigned long long v, int base = 10) { return print(String(v, (unsigned char)base)); }
+    size_t print(double v, int digits = 2) { return print(String(v, (unsigned int)digits)); }
+    size_t print(const struct tm* timeinfo, const char* format = nullptr) {
+        char buf[64];
+        strftime(buf, sizeof(buf), format ? format : "%c", timeinfo);
+        return print(buf);
+    }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T& v) { size_t n = print(v); return n + println(); }
+    template <typename T>
+    size_t println(const T& v, int arg) { size_t n = print(v, arg); return n + println(); }
+    size_t println(const struct tm* timeinfo, const char* format) { size_t n = print(timeinfo, format); return n + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char buf[512];
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        if (len < 0) return 0;
+        if ((size_t)len < sizeof(buf)) return write((const uint8_t*)buf, len);
+
+        std::vector<char> big(len + 1);
+        va_start(args, format);
+        vsnprintf(big.data(), big.size(), format, args);
+        va_end(args);
+        return write((const uint8_t*)big.data(), len);
+    }
+
+    virtual void flush() {}
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+
+    virtual size_t readBytes(char* buffer, size_t length) {
+        size_t count = 0;
+        while (count < length) {
+            int c = read();
+            if (c < 0) break;
+            *buffer++ = (char)c;
+            count++;
+        }
+        return count;
+    }
+    size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+
+    String readStringUntil(char terminator) {
+        std::string r;
+        int c;
+        while ((c = read()) >= 0 && c != terminator) r += (char)c;
+        return String(r);
+    }
+    String readString() {
+        std::string r;
+        int c;
+        while ((c = read()) >= 0) r += (char)c;
+        return String(r);
+    }
+
+protected:
+    unsigned long _timeout = 1000;
+};
+
+// Serial escreve no stdout do processo
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void end() {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    void flush() override;
+    // Silencia o Serial (ex.: durante medições de tempo)
+    void setQuiet(bool quiet) { _quiet = quiet; }
+    operator bool() const { return true; }
+
+private:
+    bool _quiet = false;
+};
+
+extern HardwareSerial Serial;
+
+// --- Tempo, GPIO e ADC ---
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t val);
+int analogRead(uint8_t pin);
+void analogReadResolution(uint8_t bits);
+
+inline int digitalPinToInterrupt(int pin) { return pin; }
+void attachInterrupt(int pin, void (*isr)(), int mode);
+void detachInterrupt(int pin);
+void noInterrupts();
+void interrupts();
+
+bool getLocalTime(struct tm* info, uint32_t ms = 5000);
+
+template <class T, class L, class H>
+auto constrain(T amt, L low, H high) -> decltype(amt) {
+    return amt < low ? low : (amt > high ? high : amt);
+}
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#endif
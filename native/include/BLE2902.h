@@ -0,0 +1,14 @@
+#ifndef NATIVE_BLE2902_H
+#define NATIVE_BLE2902_H
+
+#include "BLECharacteristic.h"
+
+// Client Characteristic Configuration: no native as notificações estão sempre ligadas
+class BLE2902 : public BLEDescriptor {
+public:
+    BLE2902() : BLEDescriptor(BLEUUID((uint16_t)0x2902)) {}
+    void setNotifications(bool flag) { (void)flag; }
+    void setIndications(bool flag) { (void)flag; }
+};
+
+#endif
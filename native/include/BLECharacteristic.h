@@ -0,0 +1,89 @@
+#ifndef NATIVE_BLE_CHARACTERISTIC_H
+#define NATIVE_BLE_CHARACTERISTIC_H
+
+#include <Arduino.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+class BLEUUID {
+public:
+    BLEUUID() {}
+    BLEUUID(const char* uuid) : _uuid(uuid ? uuid : "") {}
+    BLEUUID(const std::string& uuid) : _uuid(uuid) {}
+    explicit BLEUUID(uint16_t uuid16);
+    std::string toString() const { return _uuid; }
+    bool equals(const BLEUUID& other) const;
+
+private:
+    std::string _uuid;
+};
+
+class BLECharacteristic;
+
+class BLECharacteristicCallbacks {
+public:
+    virtual ~BLECharacteristicCallbacks() {}
+    virtual void onRead(BLECharacteristic* pCharacteristic) { (void)pCharacteristic; }
+    virtual void onWrite(BLECharacteristic* pCharacteristic) { (void)pCharacteristic; }
+};
+
+class BLEDescriptor {
+public:
+    explicit BLEDescriptor(const BLEUUID& uuid) : _uuid(uuid) {}
+    virtual ~BLEDescriptor() {}
+    BLEUUID getUUID() const { return _uuid; }
+
+private:
+    BLEUUID _uuid;
+};
+
+/**
+ * @brief Característica BLE falsa: guarda o valor atual, conta cada notify() e entrega-o
+ * ao "cliente" registado com setNotifyListener(), sem rádio.
+ */
+class BLECharacteristic {
+public:
+    static const uint32_t PROPERTY_READ = 1 << 0;
+    static const uint32_t PROPERTY_WRITE = 1 << 1;
+    static const uint32_t PROPERTY_NOTIFY = 1 << 2;
+    static const uint32_t PROPERTY_INDICATE = 1 << 3;
+    static const uint32_t PROPERTY_WRITE_NR = 1 << 4;
+
+    explicit BLECharacteristic(const BLEUUID& uuid, uint32_t properties = PROPERTY_NOTIFY);
+    ~BLECharacteristic();
+
+    void setValue(const uint8_t* data, size_t size);
+    void setValue(const std::string& value);
+    void setValue(const char* value) { setValue(std::string(value ? value : "")); }
+    void setValue(const String& value) { setValue(std::string(value.c_str(), value.length())); }
+    std::string getValue() const { return _value; }
+
+    void notify(bool isNotification = true);
+    void indicate() { notify(false); }
+
+    void setCallbacks(BLECharacteristicCallbacks* callbacks) { _callbacks = callbacks; }
+    BLECharacteristicCallbacks* getCallbacks() const { return _callbacks; }
+    void addDescriptor(BLEDescriptor* descriptor);
+    BLEDescriptor* getDescriptorByUUID(const BLEUUID& uuid);
+    BLEUUID getUUID() const { return _uuid; }
+
+    // --- Só no native ---
+    typedef std::function<void(const uint8_t* data, size_t len)> NotifyListener;
+    void setNotifyListener(NotifyListener listener) { _listener = listener; }
+    size_t notifyCount() const { return _notifyCount; }
+    size_t notifiedBytes() const { return _notifiedBytes; }
+    void clearNotifyStats();
+
+private:
+    BLEUUID _uuid;
+    uint32_t _properties;
+    std::string _value;
+    BLECharacteristicCallbacks* _callbacks;
+    std::vector<BLEDescriptor*> _descriptors;
+    NotifyListener _listener;
+    size_t _notifyCount;
+    size_t _notifiedBytes;
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef NATIVE_BLE_DEVICE_H
+#define NATIVE_BLE_DEVICE_H
+
+// Pilha BLE falsa do ambiente [env:native]: serviços e características ficam num registo
+// em memória e o cliente é simulado pelos ganchos de native_env.h.
+
+#include "BLECharacteristic.h"
+#include <vector>
+
+typedef uint8_t esp_bd_addr_t[6];
+
+typedef union {
+    struct {
+        uint16_t conn_id;
+        esp_bd_addr_t remote_bda;
+    } connect;
+    struct {
+        uint16_t conn_id;
+        esp_bd_addr_t remote_bda;
+    } disconnect;
+    struct {
+        uint16_t conn_id;
+        uint16_t mtu;
+    } mtu;
+} esp_ble_gatts_cb_param_t;
+
+class BLEServer;
+
+class BLEServerCallbacks {
+public:
+    virtual ~BLEServerCallbacks() {}
+    virtual void onConnect(BLEServer* pServer) { (void)pServer; }
+    virtual void onConnect(BLEServer* pServer, esp_ble_gatts_cb_param_t* param) { (void)pServer; (void)param; }
+    virtual void onDisconnect(BLEServer* pServer) { (void)pServer; }
+    virtual void onDisconnect(BLEServer* pServer, esp_ble_gatts_cb_param_t* param) { (void)pServer; (void)param; }
+    virtual void onMtuChanged(BLEServer* pServer, esp_ble_gatts_cb_param_t* param) { (void)pServer; (void)param; }
+};
+
+class BLEService {
+public:
+    explicit BLEService(const BLEUUID& uuid) : _uuid(uuid) {}
+    ~BLEService();
+
+    BLECharacteristic* createCharacteristic(const char* uuid, uint32_t properties);
+    BLECharacteristic* createCharacteristic(const BLEUUID& uuid, uint32_t properties);
+    void start() {}
+    BLEUUID getUUID() const { return _uuid; }
+    const std::vector<BLECharacteristic*>& characteristics() const { return _characteristics; }
+
+private:
+    BLEUUID _uuid;
+    std::vector<BLECharacteristic*> _characteristics;
+};
+
+class BLEServer {
+public:
+    BLEServer() : _callbacks(nullptr), _peerMtu(23), _connected(0) {}
+    ~BLEServer();
+
+    void setCallbacks(BLEServerCallbacks* callbacks) { _callbacks = callbacks; }
+    BLEService* createService(const char* uuid);
+    BLEService* createService(const BLEUUID& uuid, uint32_t numHandles = 15, uint8_t instId = 0);
+    uint16_t getPeerMTU(uint16_t connId) { (void)connId; return _peerMtu; }
+    uint32_t getConnectedCount() { return _connected; }
+
+    // --- Só no native ---
+    BLEServerCallbacks* getCallbacks() const { return _callbacks; }
+    void setPeerMTU(uint16_t mtu) { _peerMtu = mtu; }
+    void setConnectedCount(uint32_t count) { _connected = count; }
+    BLECharacteristic* findCharacteristic(const char* uuid) const;
+
+private:
+    BLEServerCallbacks* _callbacks;
+    std::vector<BLEService*> _services;
+    uint16_t _peerMtu;
+    uint32_t _connected;
+};
+
+class BLEAdvertising {
+public:
+    void addServiceUUID(const char* uuid) { (void)uuid; }
+    void addServiceUUID(const BLEUUID& uuid) { (void)uuid; }
+    void start() {}
+    void stop() {}
+};
+
+class BLEDevice {
+public:
+    static void init(const std::string& deviceName);
+    static BLEServer* createServer();
+    static BLEAdvertising* getAdvertising();
+    static void startAdvertising() {}
+    static void stopAdvertising() {}
+    static int setMTU(uint16_t mtu) { (void)mtu; return 0; }
+    static bool getInitialized();
+
+    // Servidor criado por createServer() (só no native)
+    static BLEServer* server();
+};
+
+#endif
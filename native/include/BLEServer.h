@@ -0,0 +1,6 @@
+#ifndef NATIVE_BLE_SERVER_H
+#define NATIVE_BLE_SERVER_H
+
+#include "BLEDevice.h"
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef NATIVE_DALLAS_TEMPERATURE_H
+#define NATIVE_DALLAS_TEMPERATURE_H
+
+// DS18B20 simulado com os tempos reais de conversão (94 ms a 9 bits ... 750 ms a 12 bits),
+// para que o custo de requestTemperatures() bloqueante apareça nos benchmarks.
+
+#include <Arduino.h>
+#include "OneWire.h"
+
+#define DEVICE_DISCONNECTED_C -127
+
+typedef uint8_t DeviceAddress[8];
+
+class DallasTemperature {
+public:
+    explicit DallasTemperature(OneWire* oneWire);
+
+    void begin();
+    uint8_t getDeviceCount() { return 1; }
+    bool getAddress(uint8_t* address, uint8_t index);
+
+    void setResolution(uint8_t bits);
+    uint8_t getResolution() { return _resolution; }
+    void setWaitForConversion(bool flag) { _waitForConversion = flag; }
+    bool getWaitForConversion() { return _waitForConversion; }
+    int16_t millisToWaitForConversion(uint8_t bits);
+
+    void requestTemperatures();
+    bool isConversionComplete();
+    float getTempCByIndex(uint8_t index);
+
+private:
+    OneWire* _oneWire;
+    uint8_t _resolution;
+    bool _waitForConversion;
+    unsigned long _conversionStart;
+    float _lastTemp;
+};
+
+#endif
@@ -0,0 +1,210 @@
+#ifndef NATIVE_ESP_ASYNC_WEB_SERVER_H
+#define NATIVE_ESP_ASYNC_WEB_SERVER_H
+
+// ESPAsyncWebServer sem rede para o ambiente [env:native]: os handlers são chamados
+// com AsyncWebServer::handle() e o corpo das respostas é puxado por pumpResponse(),
+// com os mesmos callbacks (buffer, maxLen, index) que a biblioteca usa no ESP32.
+
+#include <Arduino.h>
+#include <FS.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define RESPONSE_TRY_AGAIN 0xFFFFFFFF
+
+typedef enum {
+    HTTP_GET = 0b00000001,
+    HTTP_POST = 0b00000010,
+    HTTP_DELETE = 0b00000100,
+    HTTP_PUT = 0b00001000,
+    HTTP_PATCH = 0b00010000,
+    HTTP_HEAD = 0b00100000,
+    HTTP_OPTIONS = 0b01000000,
+    HTTP_ANY = 0b01111111,
+} WebRequestMethod;
+
+typedef std::function<size_t(uint8_t*, size_t, size_t)> AwsResponseFiller;
+
+class AsyncWebParameter {
+public:
+    AsyncWebParameter(const String& name, const String& value) : _name(name), _value(value) {}
+    const String& name() const { return _name; }
+    const String& value() const { return _value; }
+    bool isPost() const { return false; }
+    bool isFile() const { return false; }
+
+private:
+    String _name;
+    String _value;
+};
+
+class AsyncWebHeader {
+public:
+    AsyncWebHeader(const String& name, const String& value) : _name(name), _value(value) {}
+    const String& name() const { return _name; }
+    const String& value() const { return _value; }
+
+private:
+    String _name;
+    String _value;
+};
+
+class AsyncWebServerResponse {
+public:
+    AsyncWebServerResponse(int code, const String& contentType);
+    virtual ~AsyncWebServerResponse() {}
+
+    void setCode(int code) { _code = code; }
+    void setContentLength(size_t len) { _contentLength = len; }
+    void setContentType(const String& type) { _contentType = type; }
+    void addHeader(const String& name, const String& value) { _headers.emplace_back(name, value); }
+
+    int code() const { return _code; }
+    const String& contentType() const { return _contentType; }
+    size_t contentLength() const { return _contentLength; }
+    const std::vector<AsyncWebHeader>& headers() const { return _headers; }
+    const AsyncWebHeader* header(const String& name) const;
+
+    /**
+     * @brief Próximo pedaço do corpo (até maxLen bytes); 0 no fim, RESPONSE_TRY_AGAIN para repetir.
+     */
+    virtual size_t fillBody(uint8_t* buf, size_t maxLen, size_t index) = 0;
+
+protected:
+    int _code;
+    String _contentType;
+    size_t _contentLength;
+    std::vector<AsyncWebHeader> _headers;
+};
+
+class AsyncBasicResponse : public AsyncWebServerResponse {
+public:
+    AsyncBasicResponse(int code, const String& contentType, const String& content);
+    size_t fillBody(uint8_t* buf, size_t maxLen, size_t index) override;
+
+private:
+    String _content;
+};
+
+class AsyncCallbackResponse : public AsyncWebServerResponse {
+public:
+    AsyncCallbackResponse(const String& contentType, size_t len, AwsResponseFiller callback);
+    size_t fillBody(uint8_t* buf, size_t maxLen, size_t index) override;
+
+private:
+    AwsResponseFiller _callback;
+};
+
+class AsyncChunkedResponse : public AsyncWebServerResponse {
+public:
+    AsyncChunkedResponse(const String& contentType, AwsResponseFiller callback);
+    size_t fillBody(uint8_t* buf, size_t maxLen, size_t index) override;
+
+private:
+    AwsResponseFiller _callback;
+};
+
+class AsyncResponseStream : public AsyncWebServerResponse, public Print {
+public:
+    AsyncResponseStream(const String& contentType, size_t bufferSize);
+    size_t write(uint8_t data) override;
+    size_t write(const uint8_t* data, size_t len) override;
+    using Print::write;
+    size_t fillBody(uint8_t* buf, size_t maxLen, size_t index) override;
+
+private:
+    std::string _content;
+};
+
+class AsyncWebServerRequest {
+public:
+    AsyncWebServerRequest(WebRequestMethod method, const String& url);
+    ~AsyncWebServerRequest();
+
+    // Preparação do pedido (só no native)
+    void addParam(const String& name, const String& value);
+    void addHeader(const String& name, const String& value);
+
+    WebRequestMethod method() const { return _method; }
+    const String& url() const { return _url; }
+
+    size_t params() const { return _params.size(); }
+    bool hasParam(const String& name, bool post = false, bool file = false) const;
+    AsyncWebParameter* getParam(const String& name, bool post = false, bool file = false) const;
+    AsyncWebParameter* getParam(size_t num) const;
+
+    size_t headers() const { return _headers.size(); }
+    bool hasHeader(const String& name) const;
+    AsyncWebHeader* getHeader(const String& name) const;
+
+    void send(AsyncWebServerResponse* response);
+    void send(int code, const String& contentType = String(), const String& content = String());
+    void send(const String& contentType, size_t len, AwsResponseFiller callback);
+    void sendChunked(const String& contentType, AwsResponseFiller callback);
+
+    AsyncWebServerResponse* beginResponse(int code, const String& contentType = String(), const String& content = String());
+    AsyncWebServerResponse* beginResponse(const String& contentType, size_t len, AwsResponseFiller callback);
+    AsyncWebServerResponse* beginChunkedResponse(const String& contentType, AwsResponseFiller callback);
+    AsyncResponseStream* beginResponseStream(const String& contentType, size_t bufferSize = 1460);
+
+    void onDisconnect(std::function<void()> fn) { _onDisconnect = fn; }
+
+    // Resposta entregue com send() (só no native)
+    AsyncWebServerResponse* response() const { return _response; }
+
+private:
+    WebRequestMethod _method;
+    String _url;
+    std::vector<std::unique_ptr<AsyncWebParameter>> _params;
+    std::vector<std::unique_ptr<AsyncWebHeader>> _headers;
+    AsyncWebServerResponse* _response;
+    std::function<void()> _onDisconnect;
+};
+
+typedef std::function<void(AsyncWebServerRequest* request)> ArRequestHandlerFunction;
+
+class AsyncCallbackWebHandler {
+public:
+    AsyncCallbackWebHandler(const String& uri, WebRequestMethod method, ArRequestHandlerFunction fn)
+        : _uri(uri), _method(method), _fn(fn) {}
+    bool canHandle(AsyncWebServerRequest* request) const;
+    void handleRequest(AsyncWebServerRequest* request) { if (_fn) _fn(request); }
+
+private:
+    String _uri;
+    WebRequestMethod _method;
+    ArRequestHandlerFunction _fn;
+};
+
+class AsyncWebServer {
+public:
+    explicit AsyncWebServer(uint16_t port) : _port(port) {}
+
+    AsyncCallbackWebHandler& on(const char* uri, WebRequestMethod method, ArRequestHandlerFunction onRequest);
+    void begin() {}
+    void end() {}
+
+    /**
+     * @brief Entrega o pedido ao primeiro handler que o aceita, pela ordem de registo
+     * e com a mesma regra de prefixo da biblioteca ("/a" também trata "/a/b").
+     * @return false se nenhum handler aceitou (a biblioteca responderia 404).
+     */
+    bool handle(AsyncWebServerRequest* request);
+
+private:
+    uint16_t _port;
+    std::vector<std::unique_ptr<AsyncCallbackWebHandler>> _handlers;
+};
+
+/**
+ * @brief Bomba de chunks: puxa o corpo da resposta em pedaços de até chunkSize bytes,
+ * como a pilha TCP faria, e acrescenta-o a 'body' (se não for nulo).
+ * @param calls Se não for nulo, recebe o número de chamadas ao callback que produziram dados.
+ * @return Total de bytes produzidos.
+ */
+size_t pumpResponse(AsyncWebServerResponse* response, std::string* body, size_t chunkSize = 1460,
+                    size_t* calls = nullptr);
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef NATIVE_LITTLEFS_H
+#define NATIVE_LITTLEFS_H
+
+#include "FS.h"
+
+/**
+ * @brief LittleFS sobre um diretório do host. A raiz vem de NATIVE_FS_ROOT
+ * (variável de ambiente) ou de "native_fs" no diretório atual.
+ */
+class LittleFSFS : public fs::FS {
+public:
+    LittleFSFS();
+
+    bool begin(bool formatOnFail = false, const char* basePath = "/littlefs", uint8_t maxOpenFiles = 10,
+               const char* partitionLabel = "spiffs");
+    bool format();
+    size_t totalBytes();
+    size_t usedBytes();
+    void end();
+
+    // Diretório do host usado como raiz (só no ambiente native)
+    const char* hostRoot() const;
+};
+
+extern LittleFSFS LittleFS;
+
+#endif
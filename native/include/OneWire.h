@@ -0,0 +1,15 @@
+#ifndef NATIVE_ONE_WIRE_H
+#define NATIVE_ONE_WIRE_H
+
+#include <Arduino.h>
+
+class OneWire {
+public:
+    explicit OneWire(uint8_t pin) : _pin(pin) {}
+    uint8_t pin() const { return _pin; }
+
+private:
+    uint8_t _pin;
+};
+
+#endif
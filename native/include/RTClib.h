@@ -0,0 +1,38 @@
+#ifndef NATIVE_RTCLIB_H
+#define NATIVE_RTCLIB_H
+
+// DS3231 simulado: relógio do host mais o desvio definido por adjust()
+
+#include <Arduino.h>
+
+class DateTime {
+public:
+    DateTime(uint32_t t = 0);
+    DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour = 0, uint8_t min = 0, uint8_t sec = 0);
+    DateTime(const char* date, const char* time); // formato de __DATE__ e __TIME__
+
+    uint16_t year() const { return _tm.tm_year + 1900; }
+    uint8_t month() const { return _tm.tm_mon + 1; }
+    uint8_t day() const { return _tm.tm_mday; }
+    uint8_t hour() const { return _tm.tm_hour; }
+    uint8_t minute() const { return _tm.tm_min; }
+    uint8_t second() const { return _tm.tm_sec; }
+    uint32_t unixtime() const { return _unix; }
+
+private:
+    uint32_t _unix;
+    struct tm _tm;
+};
+
+class RTC_DS3231 {
+public:
+    bool begin() { return true; }
+    DateTime now();
+    void adjust(const DateTime& dt);
+    bool lostPower() { return false; }
+
+private:
+    long _offset = 0;
+};
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef NATIVE_WEB_SERVER_H
+#define NATIVE_WEB_SERVER_H
+
+// O wifi_handler inclui o WebServer síncrono do core mas só usa o ESPAsyncWebServer
+
+#include <Arduino.h>
+
+#endif
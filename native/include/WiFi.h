@@ -0,0 +1,26 @@
+#ifndef NATIVE_WIFI_H
+#define NATIVE_WIFI_H
+
+// Access Point simulado: o servidor web do native recebe pedidos por AsyncWebServer::handle()
+
+#include <Arduino.h>
+
+class IPAddress : public Printable {
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : _bytes{a, b, c, d} {}
+    String toString() const;
+    size_t printTo(Print& p) const override;
+
+private:
+    uint8_t _bytes[4];
+};
+
+class WiFiClass {
+public:
+    bool softAP(const char* ssid, const char* passphrase = nullptr);
+    IPAddress softAPIP() { return IPAddress(192, 168, 4, 1); }
+};
+
+extern WiFiClass WiFi;
+
+#endif
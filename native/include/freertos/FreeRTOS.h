@@ -0,0 +1,46 @@
+#ifndef NATIVE_FREERTOS_H
+#define NATIVE_FREERTOS_H
+
+// FreeRTOS mínimo sobre std::thread/std::mutex para o ambiente [env:native]
+
+#include <cstdint>
+#include <atomic>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef struct NativeTask* TaskHandle_t;
+typedef struct NativeSemaphore* SemaphoreHandle_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY 0xffffffffUL
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define tskIDLE_PRIORITY 0
+#define configMAX_PRIORITIES 25
+
+// Spinlock das secções críticas (no ESP32 também desativa interrupções do core)
+typedef struct {
+    std::atomic<int> locked;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+
+inline void vPortEnterCritical(portMUX_TYPE* mux) {
+    while (mux->locked.exchange(1, std::memory_order_acquire)) {
+    }
+}
+
+inline void vPortExitCritical(portMUX_TYPE* mux) {
+    mux->locked.store(0, std::memory_order_release);
+}
+
+#define portENTER_CRITICAL(mux) vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux) vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux) vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux) vPortExitCritical(mux)
+
+#endif
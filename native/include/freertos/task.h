@@ -0,0 +1,34 @@
+#ifndef NATIVE_TASK_H
+#define NATIVE_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void*);
+
+typedef enum {
+    eNoAction = 0,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite,
+    eSetValueWithoutOverwrite
+} eNotifyAction;
+
+// As tarefas correm em std::thread; core e prioridade são ignorados
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth, void* param,
+                                   UBaseType_t priority, TaskHandle_t* createdTask, BaseType_t coreId);
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth, void* param,
+                       UBaseType_t priority, TaskHandle_t* createdTask);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+BaseType_t xPortGetCoreID();
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+BaseType_t xTaskNotifyWait(uint32_t bitsToClearOnEntry, uint32_t bitsToClearOnExit,
+                           uint32_t* notificationValue, TickType_t ticksToWait);
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait);
+uint32_t ulTaskNotifyValueClear(TaskHandle_t task, uint32_t bitsToClear);
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef NATIVE_ENV_H
+#define NATIVE_ENV_H
+
+// Ganchos do ambiente [env:native] para simular o hardware e o cliente BLE
+
+#include <Arduino.h>
+#include <functional>
+#include "BLECharacteristic.h"
+
+// Substitui o gerador de leituras do ADC (padrão: ruído em torno de meia escala)
+void nativeSetAnalogReader(std::function<int(uint8_t pin)> reader);
+
+// Chama 'count' vezes a ISR registada com attachInterrupt() no pino (ex.: pulsos do FlowSensor)
+void nativeTriggerInterrupt(int pin, unsigned count = 1);
+
+// Característica criada pelo setupBLE() com este UUID (nullptr se não existir)
+BLECharacteristic* nativeFindCharacteristic(const char* uuid);
+
+// Cliente BLE simulado: liga com o MTU indicado (23 = sem negociação) e desliga
+void nativeBleConnect(uint16_t mtu = 23);
+void nativeBleDisconnect();
+
+// Escrita do cliente numa característica: chama o onWrite() registado, como a pilha BLE
+bool nativeBleWrite(const char* uuid, const uint8_t* data, size_t len);
+
+#endif
@@ -0,0 +1,157 @@
+// Core Arduino do ambiente [env:native]: Serial no stdout, tempo do relógio monotónico,
+// ADC com ruído pseudoaleatório e tabela de ISRs disparadas por nativeTriggerInterrupt().
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "native_env.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+size_t HardwareSerial::write(uint8_t c) {
+    if (_quiet) return 1;
+    return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    if (_quiet) return size;
+    return fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush() {
+    fflush(stdout);
+}
+
+// --- Tempo ---
+
+// Sem configTzTime() o ESP32 trabalha em UTC; o host segue o mesmo fuso para os diretórios diários
+static struct NativeTimeZone {
+    NativeTimeZone() {
+        setenv("TZ", "UTC0", 1);
+        tzset();
+    }
+} nativeTimeZone;
+
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long micros() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() {
+    std::this_thread::yield();
+}
+
+bool getLocalTime(struct tm* info, uint32_t ms) {
+    (void)ms;
+    time_t now = time(nullptr);
+    localtime_r(&now, info);
+    return true;
+}
+
+// --- Números aleatórios ---
+
+static uint32_t randomState = 0x12345678;
+
+void randomSeed(unsigned long seed) {
+    if (seed != 0) randomState = (uint32_t)seed;
+}
+
+// xorshift32: determinístico entre execuções, útil para comparar benchmarks
+static uint32_t nextRandom() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+long random(long howbig) {
+    return howbig <= 0 ? 0 : (long)(nextRandom() % (uint32_t)howbig);
+}
+
+long random(long howsmall, long howbig) {
+    return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+// --- GPIO e ADC ---
+
+static std::function<int(uint8_t)> analogReader;
+
+void nativeSetAnalogReader(std::function<int(uint8_t pin)> reader) {
+    analogReader = reader;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    (void)pin;
+    (void)mode;
+}
+
+int digitalRead(uint8_t pin) {
+    (void)pin;
+    return LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    (void)pin;
+    (void)val;
+}
+
+int analogRead(uint8_t pin) {
+    if (analogReader) return analogReader(pin);
+    // Meia escala do ADC de 12 bits com ±32 contagens de ruído
+    return 2048 + (int)random(-32, 33);
+}
+
+void analogReadResolution(uint8_t bits) {
+    (void)bits;
+}
+
+// --- Interrupções ---
+
+static std::map<int, void (*)()> isrTable;
+static std::recursive_mutex interruptMutex;
+
+void attachInterrupt(int pin, void (*isr)(), int mode) {
+    (void)mode;
+    std::lock_guard<std::recursive_mutex> lock(interruptMutex);
+    isrTable[pin] = isr;
+}
+
+void detachInterrupt(int pin) {
+    std::lock_guard<std::recursive_mutex> lock(interruptMutex);
+    isrTable.erase(pin);
+}
+
+// noInterrupts()/interrupts() excluem as ISRs simuladas, como no ESP32
+void noInterrupts() {
+    interruptMutex.lock();
+}
+
+void interrupts() {
+    interruptMutex.unlock();
+}
+
+void nativeTriggerInterrupt(int pin, unsigned count) {
+    std::lock_guard<std::recursive_mutex> lock(interruptMutex);
+    auto it = isrTable.find(pin);
+    if (it == isrTable.end() || !it->second) return;
+    for (unsigned i = 0; i < count; i++) it->second();
+}
@@ -0,0 +1,200 @@
+// ESPAsyncWebServer do ambiente [env:native]: mesma API de pedidos e respostas,
+// sem pilha TCP. O corpo é puxado por pumpResponse() com os callbacks da biblioteca.
+
+#include <ESPAsyncWebServer.h>
+
+// --- Respostas ---
+
+AsyncWebServerResponse::AsyncWebServerResponse(int code, const String& contentType)
+    : _code(code), _contentType(contentType), _contentLength(0) {
+}
+
+const AsyncWebHeader* AsyncWebServerResponse::header(const String& name) const {
+    for (const AsyncWebHeader& h : _headers) {
+        if (h.name().equalsIgnoreCase(name)) return &h;
+    }
+    return nullptr;
+}
+
+AsyncBasicResponse::AsyncBasicResponse(int code, const String& contentType, const String& content)
+    : AsyncWebServerResponse(code, contentType), _content(content) {
+    _contentLength = _content.length();
+}
+
+size_t AsyncBasicResponse::fillBody(uint8_t* buf, size_t maxLen, size_t index) {
+    if (index >= _content.length()) return 0;
+    size_t len = std::min(maxLen, (size_t)_content.length() - index);
+    memcpy(buf, _content.c_str() + index, len);
+    return len;
+}
+
+AsyncCallbackResponse::AsyncCallbackResponse(const String& contentType, size_t len, AwsResponseFiller callback)
+    : AsyncWebServerResponse(200, contentType), _callback(callback) {
+    _contentLength = len;
+}
+
+size_t AsyncCallbackResponse::fillBody(uint8_t* buf, size_t maxLen, size_t index) {
+    if (index >= _contentLength || !_callback) return 0;
+    // A biblioteca nunca pede mais do que o que falta do Content-Length
+    return _callback(buf, std::min(maxLen, _contentLength - index), index);
+}
+
+AsyncChunkedResponse::AsyncChunkedResponse(const String& contentType, AwsResponseFiller callback)
+    : AsyncWebServerResponse(200, contentType), _callback(callback) {
+    addHeader("Transfer-Encoding", "chunked");
+}
+
+size_t AsyncChunkedResponse::fillBody(uint8_t* buf, size_t maxLen, size_t index) {
+    return _callback ? _callback(buf, maxLen, index) : 0;
+}
+
+AsyncResponseStream::AsyncResponseStream(const String& contentType, size_t bufferSize)
+    : AsyncWebServerResponse(200, contentType) {
+    _content.reserve(bufferSize);
+}
+
+size_t AsyncResponseStream::write(uint8_t data) {
+    _content.push_back((char)data);
+    _contentLength = _content.size();
+    return 1;
+}
+
+size_t AsyncResponseStream::write(const uint8_t* data, size_t len) {
+    _content.append((const char*)data, len);
+    _contentLength = _content.size();
+    return len;
+}
+
+size_t AsyncResponseStream::fillBody(uint8_t* buf, size_t maxLen, size_t index) {
+    if (index >= _content.size()) return 0;
+    size_t len = std::min(maxLen, _content.size() - index);
+    memcpy(buf, _content.data() + index, len);
+    return len;
+}
+
+size_t pumpResponse(AsyncWebServerResponse* response, std::string* body, size_t chunkSize, size_t* calls) {
+    if (calls) *calls = 0;
+    if (!response || chunkSize == 0) return 0;
+
+    std::vector<uint8_t> buf(chunkSize);
+    size_t index = 0;
+    while (true) {
+        size_t len = response->fillBody(buf.data(), buf.size(), index);
+        if (len == RESPONSE_TRY_AGAIN) {
+            yield();
+            continue;
+        }
+        if (len == 0) break;
+        if (len > buf.size()) len = buf.size(); // a biblioteca também trunca
+        if (body) body->append((const char*)buf.data(), len);
+        if (calls) (*calls)++;
+        index += len;
+    }
+    return index;
+}
+
+// --- Pedidos ---
+
+AsyncWebServerRequest::AsyncWebServerRequest(WebRequestMethod method, const String& url)
+    : _method(method), _url(url), _response(nullptr) {
+}
+
+AsyncWebServerRequest::~AsyncWebServerRequest() {
+    if (_onDisconnect) _onDisconnect();
+    delete _response;
+}
+
+void AsyncWebServerRequest::addParam(const String& name, const String& value) {
+    _params.emplace_back(new AsyncWebParameter(name, value));
+}
+
+void AsyncWebServerRequest::addHeader(const String& name, const String& value) {
+    _headers.emplace_back(new AsyncWebHeader(name, value));
+}
+
+bool AsyncWebServerRequest::hasParam(const String& name, bool post, bool file) const {
+    return getParam(name, post, file) != nullptr;
+}
+
+AsyncWebParameter* AsyncWebServerRequest::getParam(const String& name, bool post, bool file) const {
+    (void)post;
+    (void)file;
+    for (const auto& p : _params) {
+        if (p->name() == name) return p.get();
+    }
+    return nullptr;
+}
+
+AsyncWebParameter* AsyncWebServerRequest::getParam(size_t num) const {
+    return num < _params.size() ? _params[num].get() : nullptr;
+}
+
+bool AsyncWebServerRequest::hasHeader(const String& name) const {
+    return getHeader(name) != nullptr;
+}
+
+AsyncWebHeader* AsyncWebServerRequest::getHeader(const String& name) const {
+    for (const auto& h : _headers) {
+        if (h->name().equalsIgnoreCase(name)) return h.get();
+    }
+    return nullptr;
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse* response) {
+    delete _response;
+    _response = response;
+}
+
+void AsyncWebServerRequest::send(int code, const String& contentType, const String& content) {
+    send(beginResponse(code, contentType, content));
+}
+
+void AsyncWebServerRequest::send(const String& contentType, size_t len, AwsResponseFiller callback) {
+    send(beginResponse(contentType, len, callback));
+}
+
+void AsyncWebServerRequest::sendChunked(const String& contentType, AwsResponseFiller callback) {
+    send(beginChunkedResponse(contentType, callback));
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, const String& contentType, const String& content) {
+    return new AsyncBasicResponse(code, contentType, content);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(const String& contentType, size_t len, AwsResponseFiller callback) {
+    return new AsyncCallbackResponse(contentType, len, callback);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginChunkedResponse(const String& contentType, AwsResponseFiller callback) {
+    return new AsyncChunkedResponse(contentType, callback);
+}
+
+AsyncResponseStream* AsyncWebServerRequest::beginResponseStream(const String& contentType, size_t bufferSize) {
+    return new AsyncResponseStream(contentType, bufferSize);
+}
+
+// --- Servidor ---
+
+bool AsyncCallbackWebHandler::canHandle(AsyncWebServerRequest* request) const {
+    if (!(_method & request->method())) return false;
+    if (_uri.length() && _uri.endsWith("*")) {
+        return request->url().startsWith(_uri.substring(0, _uri.length() - 1));
+    }
+    // Regra da biblioteca: "/a" trata "/a" e "/a/..."
+    return !_uri.length() || _uri == request->url() || request->url().startsWith(_uri + "/");
+}
+
+AsyncCallbackWebHandler& AsyncWebServer::on(const char* uri, WebRequestMethod method, ArRequestHandlerFunction onRequest) {
+    _handlers.emplace_back(new AsyncCallbackWebHandler(uri, method, onRequest));
+    return *_handlers.back();
+}
+
+bool AsyncWebServer::handle(AsyncWebServerRequest* request) {
+    for (const auto& handler : _handlers) {
+        if (handler->canHandle(request)) {
+            handler->handleRequest(request);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,181 @@
+// Pilha BLE do ambiente [env:native]: o ble_handler corre sem alterações e o cliente
+// (app) é simulado com nativeBleConnect()/nativeBleWrite() e os ouvintes de notify().
+
+#include <BLEDevice.h>
+#include <BLE2902.h>
+#include "native_env.h"
+
+static BLEServer* nativeServer = nullptr;
+static BLEAdvertising nativeAdvertising;
+static bool nativeInitialized = false;
+
+// --- BLEUUID ---
+
+BLEUUID::BLEUUID(uint16_t uuid16) {
+    char buf[40];
+    snprintf(buf, sizeof(buf), "0000%04x-0000-1000-8000-00805f9b34fb", uuid16);
+    _uuid = buf;
+}
+
+bool BLEUUID::equals(const BLEUUID& other) const {
+    return strcasecmp(_uuid.c_str(), other._uuid.c_str()) == 0;
+}
+
+// --- BLECharacteristic ---
+
+BLECharacteristic::BLECharacteristic(const BLEUUID& uuid, uint32_t properties)
+    : _uuid(uuid), _properties(properties), _callbacks(nullptr), _notifyCount(0), _notifiedBytes(0) {
+}
+
+BLECharacteristic::~BLECharacteristic() {
+    for (BLEDescriptor* descriptor : _descriptors) delete descriptor;
+}
+
+void BLECharacteristic::setValue(const uint8_t* data, size_t size) {
+    _value.assign((const char*)data, size);
+}
+
+void BLECharacteristic::setValue(const std::string& value) {
+    _value = value;
+}
+
+void BLECharacteristic::notify(bool isNotification) {
+    (void)isNotification;
+    _notifyCount++;
+    _notifiedBytes += _value.size();
+    if (_listener) _listener((const uint8_t*)_value.data(), _value.size());
+}
+
+void BLECharacteristic::addDescriptor(BLEDescriptor* descriptor) {
+    _descriptors.push_back(descriptor);
+}
+
+BLEDescriptor* BLECharacteristic::getDescriptorByUUID(const BLEUUID& uuid) {
+    for (BLEDescriptor* descriptor : _descriptors) {
+        if (descriptor->getUUID().equals(uuid)) return descriptor;
+    }
+    return nullptr;
+}
+
+void BLECharacteristic::clearNotifyStats() {
+    _notifyCount = 0;
+    _notifiedBytes = 0;
+}
+
+// --- BLEService / BLEServer ---
+
+BLEService::~BLEService() {
+    for (BLECharacteristic* characteristic : _characteristics) delete characteristic;
+}
+
+BLECharacteristic* BLEService::createCharacteristic(const char* uuid, uint32_t properties) {
+    return createCharacteristic(BLEUUID(uuid), properties);
+}
+
+BLECharacteristic* BLEService::createCharacteristic(const BLEUUID& uuid, uint32_t properties) {
+    BLECharacteristic* characteristic = new BLECharacteristic(uuid, properties);
+    _characteristics.push_back(characteristic);
+    return characteristic;
+}
+
+BLEServer::~BLEServer() {
+    for (BLEService* service : _services) delete service;
+}
+
+BLEService* BLEServer::createService(const char* uuid) {
+    return createService(BLEUUID(uuid));
+}
+
+BLEService* BLEServer::createService(const BLEUUID& uuid, uint32_t numHandles, uint8_t instId) {
+    (void)numHandles;
+    (void)instId;
+    BLEService* service = new BLEService(uuid);
+    _services.push_back(service);
+    return service;
+}
+
+BLECharacteristic* BLEServer::findCharacteristic(const char* uuid) const {
+    BLEUUID wanted(uuid);
+    for (BLEService* service : _services) {
+        for (BLECharacteristic* characteristic : service->characteristics()) {
+            if (characteristic->getUUID().equals(wanted)) return characteristic;
+        }
+    }
+    return nullptr;
+}
+
+// --- BLEDevice ---
+
+void BLEDevice::init(const std::string& deviceName) {
+    (void)deviceName;
+    nativeInitialized = true;
+}
+
+BLEServer* BLEDevice::createServer() {
+    if (!nativeServer) nativeServer = new BLEServer();
+    return nativeServer;
+}
+
+BLEAdvertising* BLEDevice::getAdvertising() {
+    return &nativeAdvertising;
+}
+
+bool BLEDevice::getInitialized() {
+    return nativeInitialized;
+}
+
+BLEServer* BLEDevice::server() {
+    return nativeServer;
+}
+
+// --- Cliente simulado ---
+
+BLECharacteristic* nativeFindCharacteristic(const char* uuid) {
+    return nativeServer ? nativeServer->findCharacteristic(uuid) : nullptr;
+}
+
+void nativeBleConnect(uint16_t mtu) {
+    if (!nativeServer) return;
+    esp_ble_gatts_cb_param_t param = {};
+    param.connect.conn_id = 0;
+    // Endereço fixo do cliente simulado
+    const uint8_t bda[6] = {0x02, 0x4E, 0x41, 0x54, 0x49, 0x56};
+    memcpy(param.connect.remote_bda, bda, sizeof(bda));
+
+    nativeServer->setPeerMTU(23);
+    nativeServer->setConnectedCount(1);
+    BLEServerCallbacks* callbacks = nativeServer->getCallbacks();
+    if (callbacks) {
+        callbacks->onConnect(nativeServer);
+        callbacks->onConnect(nativeServer, &param);
+    }
+
+    // A negociação de MTU chega depois da ligação, como num telemóvel
+    if (mtu > 23) {
+        nativeServer->setPeerMTU(mtu);
+        esp_ble_gatts_cb_param_t mtuParam = {};
+        mtuParam.mtu.conn_id = 0;
+        mtuParam.mtu.mtu = mtu;
+        if (callbacks) callbacks->onMtuChanged(nativeServer, &mtuParam);
+    }
+}
+
+void nativeBleDisconnect() {
+    if (!nativeServer) return;
+    esp_ble_gatts_cb_param_t param = {};
+    nativeServer->setConnectedCount(0);
+    nativeServer->setPeerMTU(23);
+    BLEServerCallbacks* callbacks = nativeServer->getCallbacks();
+    if (callbacks) {
+        callbacks->onDisconnect(nativeServer);
+        callbacks->onDisconnect(nativeServer, &param);
+    }
+}
+
+bool nativeBleWrite(const char* uuid, const uint8_t* data, size_t len) {
+    BLECharacteristic* characteristic = nativeFindCharacteristic(uuid);
+    if (!characteristic) return false;
+    characteristic->setValue(data, len);
+    if (characteristic->getCallbacks()) characteristic->getCallbacks()->onWrite(characteristic);
+    return true;
+}
@@ -0,0 +1,90 @@
+// Periféricos simulados do ambiente [env:native]: DS18B20 (DallasTemperature) e DS3231 (RTClib)
+
+#include <DallasTemperature.h>
+#include <RTClib.h>
+
+// --- DallasTemperature ---
+
+DallasTemperature::DallasTemperature(OneWire* oneWire)
+    : _oneWire(oneWire), _resolution(12), _waitForConversion(true), _conversionStart(0), _lastTemp(22.0f) {
+}
+
+void DallasTemperature::begin() {
+}
+
+bool DallasTemperature::getAddress(uint8_t* address, uint8_t index) {
+    if (index != 0) return false;
+    static const uint8_t fakeAddress[8] = {0x28, 0x4E, 0x41, 0x50, 0x44, 0x4C, 0x00, 0x01};
+    memcpy(address, fakeAddress, sizeof(fakeAddress));
+    return true;
+}
+
+void DallasTemperature::setResolution(uint8_t bits) {
+    _resolution = constrain(bits, (uint8_t)9, (uint8_t)12);
+}
+
+int16_t DallasTemperature::millisToWaitForConversion(uint8_t bits) {
+    switch (bits) {
+        case 9: return 94;
+        case 10: return 188;
+        case 11: return 375;
+        default: return 750;
+    }
+}
+
+void DallasTemperature::requestTemperatures() {
+    _conversionStart = millis();
+    // Temperatura lenta em torno dos 22 °C, quantizada à resolução configurada
+    float step = 0.5f / (1 << (_resolution - 9));
+    float temp = 22.0f + 1.5f * sinf(millis() / 60000.0f) + random(-2, 3) * step;
+    _lastTemp = roundf(temp / step) * step;
+    if (_waitForConversion) delay(millisToWaitForConversion(_resolution));
+}
+
+bool DallasTemperature::isConversionComplete() {
+    return millis() - _conversionStart >= (unsigned long)millisToWaitForConversion(_resolution);
+}
+
+float DallasTemperature::getTempCByIndex(uint8_t index) {
+    return index == 0 ? _lastTemp : DEVICE_DISCONNECTED_C;
+}
+
+// --- RTClib ---
+
+DateTime::DateTime(uint32_t t) : _unix(t) {
+    time_t tt = t;
+    gmtime_r(&tt, &_tm);
+}
+
+DateTime::DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t min, uint8_t sec) {
+    struct tm timeinfo = {};
+    timeinfo.tm_year = year - 1900;
+    timeinfo.tm_mon = month - 1;
+    timeinfo.tm_mday = day;
+    timeinfo.tm_hour = hour;
+    timeinfo.tm_min = min;
+    timeinfo.tm_sec = sec;
+    // Como no RTClib, a hora não tem fuso: é tratada como UTC
+    _unix = (uint32_t)timegm(&timeinfo);
+    time_t tt = _unix;
+    gmtime_r(&tt, &_tm);
+}
+
+DateTime::DateTime(const char* date, const char* time) {
+    static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    char monthName[4] = {};
+    int day = 1, year = 2000, hour = 0, min = 0, sec = 0;
+    sscanf(date, "%3s %d %d", monthName, &day, &year);
+    sscanf(time, "%d:%d:%d", &hour, &min, &sec);
+    const char* found = strstr(months, monthName);
+    int month = found ? (int)(found - months) / 3 + 1 : 1;
+    *this = DateTime(year, month, day, hour, min, sec);
+}
+
+DateTime RTC_DS3231::now() {
+    return DateTime((uint32_t)(::time(nullptr) + _offset));
+}
+
+void RTC_DS3231::adjust(const DateTime& dt) {
+    _offset = (long)dt.unixtime() - (long)::time(nullptr);
+}
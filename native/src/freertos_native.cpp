@@ -0,0 +1,196 @@
+// FreeRTOS do ambiente [env:native]: tarefas em std::thread, semáforos em std::mutex
+// e notificações de tarefa com std::condition_variable.
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <Arduino.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct NativeSemaphore {
+    bool recursive;
+    std::timed_mutex mutex;
+    std::recursive_timed_mutex recursiveMutex;
+};
+
+struct NativeTask {
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t notifyValue = 0;
+    bool notifyPending = false;
+};
+
+// Handle da tarefa em execução (o "loop" principal também ganha um, criado a pedido)
+static thread_local NativeTask* currentTask = nullptr;
+
+// --- Semáforos ---
+
+static SemaphoreHandle_t createSemaphore(bool recursive) {
+    NativeSemaphore* sem = new NativeSemaphore();
+    sem->recursive = recursive;
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return createSemaphore(false);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+    return createSemaphore(true);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem) {
+    delete sem;
+}
+
+template <typename M>
+static BaseType_t takeWithTimeout(M& mutex, TickType_t ticks) {
+    if (ticks == portMAX_DELAY) {
+        mutex.lock();
+        return pdTRUE;
+    }
+    return mutex.try_lock_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+    if (!sem) return pdFALSE;
+    return sem->recursive ? takeWithTimeout(sem->recursiveMutex, ticks) : takeWithTimeout(sem->mutex, ticks);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    if (!sem) return pdFALSE;
+    if (sem->recursive) sem->recursiveMutex.unlock();
+    else sem->mutex.unlock();
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t sem, TickType_t ticks) {
+    return xSemaphoreTake(sem, ticks);
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem) {
+    return xSemaphoreGive(sem);
+}
+
+// --- Tarefas ---
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth, void* param,
+                                   UBaseType_t priority, TaskHandle_t* createdTask, BaseType_t coreId) {
+    (void)name;
+    (void)stackDepth;
+    (void)priority;
+    (void)coreId;
+
+    NativeTask* task = new NativeTask();
+    if (createdTask) *createdTask = task;
+    task->thread = std::thread([task, code, param]() {
+        currentTask = task;
+        code(param);
+    });
+    // Tarefas do firmware nunca terminam com return; o processo termina com elas a correr
+    task->thread.detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth, void* param,
+                       UBaseType_t priority, TaskHandle_t* createdTask) {
+    return xTaskCreatePinnedToCore(code, name, stackDepth, param, priority, createdTask, 0);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    // Só a auto-eliminação é suportada: a thread termina quando a função da tarefa retorna
+    (void)task;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    delay(ticks * portTICK_PERIOD_MS);
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)(millis() / portTICK_PERIOD_MS);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    if (!currentTask) currentTask = new NativeTask();
+    return currentTask;
+}
+
+BaseType_t xPortGetCoreID() {
+    return 1;
+}
+
+// --- Notificações ---
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action) {
+    if (!task) return pdFAIL;
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        switch (action) {
+            case eSetBits: task->notifyValue |= value; break;
+            case eIncrement: task->notifyValue++; break;
+            case eSetValueWithOverwrite: task->notifyValue = value; break;
+            case eSetValueWithoutOverwrite:
+                if (task->notifyPending) return pdFAIL;
+                task->notifyValue = value;
+                break;
+            case eNoAction: break;
+        }
+        task->notifyPending = true;
+    }
+    task->cv.notify_all();
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    return xTaskNotify(task, 0, eIncrement);
+}
+
+// Espera até haver notificação pendente; false se o tempo esgotar
+static bool waitNotification(NativeTask* task, std::unique_lock<std::mutex>& lock, TickType_t ticksToWait) {
+    if (ticksToWait == portMAX_DELAY) {
+        task->cv.wait(lock, [task]() { return task->notifyPending; });
+        return true;
+    }
+    return task->cv.wait_for(lock, std::chrono::milliseconds(ticksToWait * portTICK_PERIOD_MS),
+                             [task]() { return task->notifyPending; });
+}
+
+BaseType_t xTaskNotifyWait(uint32_t bitsToClearOnEntry, uint32_t bitsToClearOnExit,
+                           uint32_t* notificationValue, TickType_t ticksToWait) {
+    NativeTask* task = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> lock(task->mutex);
+    if (!task->notifyPending) task->notifyValue &= ~bitsToClearOnEntry;
+
+    bool received = waitNotification(task, lock, ticksToWait);
+    if (notificationValue) *notificationValue = task->notifyValue;
+    if (!received) return pdFALSE;
+
+    task->notifyValue &= ~bitsToClearOnExit;
+    task->notifyPending = false;
+    return pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait) {
+    NativeTask* task = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> lock(task->mutex);
+    if (task->notifyValue == 0) {
+        task->notifyPending = false;
+        waitNotification(task, lock, ticksToWait);
+    }
+    uint32_t value = task->notifyValue;
+    if (value != 0) task->notifyValue = clearCountOnExit ? 0 : value - 1;
+    task->notifyPending = task->notifyValue != 0;
+    return value;
+}
+
+uint32_t ulTaskNotifyValueClear(TaskHandle_t task, uint32_t bitsToClear) {
+    if (!task) task = xTaskGetCurrentTaskHandle();
+    std::lock_guard<std::mutex> lock(task->mutex);
+    uint32_t previous = task->notifyValue;
+    task->notifyValue &= ~bitsToClear;
+    return previous;
+}
@@ -0,0 +1,324 @@
+// LittleFS do ambiente [env:native] sobre um diretório do host, com a semântica do core 2.x:
+// name() devolve só o nome base, mkdir cria um único nível e abrir para escrita
+// num diretório inexistente falha.
+
+#include <LittleFS.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+// Tamanho da partição spiffs do huge_app.csv (0xE0000)
+#define NATIVE_FS_DEFAULT_TOTAL_BYTES (896 * 1024)
+#define NATIVE_FS_BLOCK_SIZE 4096
+
+namespace fs {
+
+class FileImpl {
+public:
+    FileImpl(const std::string& hostPath, const std::string& path, FILE* f, bool isDir)
+        : hostPath(hostPath), path(path), file(f), isDir(isDir), dir(nullptr) {
+        size_t slash = path.find_last_of('/');
+        name = slash == std::string::npos ? path : path.substr(slash + 1);
+        if (isDir) dir = opendir(hostPath.c_str());
+    }
+
+    ~FileImpl() { close(); }
+
+    void close() {
+        if (file) fclose(file);
+        if (dir) closedir(dir);
+        file = nullptr;
+        dir = nullptr;
+        isDir = false;
+    }
+
+    std::string hostPath;
+    std::string path;
+    std::string name;
+    FILE* file;
+    bool isDir;
+    DIR* dir;
+};
+
+class FSImpl {
+public:
+    std::string root;
+
+    std::string hostPath(const char* path) const {
+        std::string p = path ? path : "";
+        if (p.empty() || p[0] != '/') p = "/" + p;
+        return root + p;
+    }
+};
+
+static std::string normalizePath(const char* path) {
+    std::string p = path ? path : "";
+    if (p.empty() || p[0] != '/') p = "/" + p;
+    while (p.size() > 1 && p.back() == '/') p.pop_back();
+    return p;
+}
+
+// --- File ---
+
+size_t File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buf, size_t size) {
+    if (!_p || !_p->file) return 0;
+    return fwrite(buf, 1, size, _p->file);
+}
+
+int File::available() {
+    if (!_p || !_p->file) return 0;
+    return (int)(size() - position());
+}
+
+int File::read() {
+    if (!_p || !_p->file) return -1;
+    int c = fgetc(_p->file);
+    return c == EOF ? -1 : c;
+}
+
+int File::peek() {
+    if (!_p || !_p->file) return -1;
+    int c = fgetc(_p->file);
+    if (c == EOF) return -1;
+    ungetc(c, _p->file);
+    return c;
+}
+
+void File::flush() {
+    if (_p && _p->file) fflush(_p->file);
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+    if (!_p || !_p->file) return 0;
+    return fread(buf, 1, size, _p->file);
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!_p || !_p->file) return false;
+    int whence = mode == SeekCur ? SEEK_CUR : (mode == SeekEnd ? SEEK_END : SEEK_SET);
+    return fseek(_p->file, (long)pos, whence) == 0;
+}
+
+size_t File::position() const {
+    if (!_p || !_p->file) return 0;
+    long pos = ftell(_p->file);
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+    if (!_p || !_p->file) return 0;
+    fflush(_p->file);
+    struct stat st;
+    if (fstat(fileno(_p->file), &st) != 0) return 0;
+    return (size_t)st.st_size;
+}
+
+void File::close() {
+    if (_p) _p->close();
+    _p.reset();
+}
+
+File::operator bool() const {
+    return _p && (_p->file || _p->isDir);
+}
+
+time_t File::getLastWrite() {
+    if (!_p) return 0;
+    if (_p->file) fflush(_p->file);
+    struct stat st;
+    if (stat(_p->hostPath.c_str(), &st) != 0) return 0;
+    return st.st_mtime;
+}
+
+const char* File::path() const {
+    return _p ? _p->path.c_str() : nullptr;
+}
+
+const char* File::name() const {
+    return _p ? _p->name.c_str() : nullptr;
+}
+
+bool File::isDirectory() {
+    return _p && _p->isDir;
+}
+
+File File::openNextFile(const char* mode) {
+    if (!_p || !_p->dir) return File();
+
+    struct dirent* entry;
+    while ((entry = readdir(_p->dir)) != nullptr) {
+        std::string entryName = entry->d_name;
+        if (entryName == "." || entryName == "..") continue;
+
+        std::string childPath = (_p->path == "/" ? "" : _p->path) + "/" + entryName;
+        std::string childHost = _p->hostPath + "/" + entryName;
+        struct stat st;
+        if (stat(childHost.c_str(), &st) != 0) continue;
+
+        if (S_ISDIR(st.st_mode)) {
+            return File(std::make_shared<FileImpl>(childHost, childPath, nullptr, true));
+        }
+        const char* fmode = (mode && mode[0] == 'r') ? "rb" : (mode && mode[0] == 'a' ? "ab+" : "wb+");
+        FILE* f = fopen(childHost.c_str(), fmode);
+        if (!f) continue;
+        return File(std::make_shared<FileImpl>(childHost, childPath, f, false));
+    }
+    return File();
+}
+
+void File::rewindDirectory() {
+    if (_p && _p->dir) rewinddir(_p->dir);
+}
+
+// --- FS ---
+
+File FS::open(const char* path, const char* mode, const bool create) {
+    if (!_impl || !path) return File();
+    std::string p = normalizePath(path);
+    std::string host = _impl->hostPath(p.c_str());
+
+    struct stat st;
+    bool exists = stat(host.c_str(), &st) == 0;
+    bool reading = !mode || mode[0] == 'r';
+
+    if (exists && S_ISDIR(st.st_mode)) {
+        return reading ? File(std::make_shared<FileImpl>(host, p, nullptr, true)) : File();
+    }
+    if (reading && !exists) return File();
+
+    if (!reading && create) {
+        // create=true cria os diretórios intermédios, como no core 2.x
+        size_t slash = p.find('/', 1);
+        while (slash != std::string::npos) {
+            ::mkdir(_impl->hostPath(p.substr(0, slash).c_str()).c_str(), 0755);
+            slash = p.find('/', slash + 1);
+        }
+    }
+
+    const char* fmode = "rb";
+    if (mode && mode[0] == 'w') fmode = mode[1] == '+' ? "wb+" : "wb";
+    else if (mode && mode[0] == 'a') fmode = mode[1] == '+' ? "ab+" : "ab";
+    else if (mode && mode[1] == '+') fmode = "rb+";
+
+    FILE* f = fopen(host.c_str(), fmode);
+    if (!f) return File();
+    return File(std::make_shared<FileImpl>(host, p, f, false));
+}
+
+bool FS::exists(const char* path) {
+    if (!_impl || !path) return false;
+    struct stat st;
+    return stat(_impl->hostPath(normalizePath(path).c_str()).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path) {
+    if (!_impl || !path) return false;
+    std::string host = _impl->hostPath(normalizePath(path).c_str());
+    struct stat st;
+    if (stat(host.c_str(), &st) != 0 || S_ISDIR(st.st_mode)) return false;
+    return unlink(host.c_str()) == 0;
+}
+
+bool FS::rename(const char* pathFrom, const char* pathTo) {
+    if (!_impl || !pathFrom || !pathTo) return false;
+    return ::rename(_impl->hostPath(normalizePath(pathFrom).c_str()).c_str(),
+                    _impl->hostPath(normalizePath(pathTo).c_str()).c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+    if (!_impl || !path) return false;
+    std::string host = _impl->hostPath(normalizePath(path).c_str());
+    struct stat st;
+    if (stat(host.c_str(), &st) == 0) return S_ISDIR(st.st_mode);
+    return ::mkdir(host.c_str(), 0755) == 0;
+}
+
+bool FS::rmdir(const char* path) {
+    if (!_impl || !path) return false;
+    return ::rmdir(_impl->hostPath(normalizePath(path).c_str()).c_str()) == 0;
+}
+
+} // namespace fs
+
+// --- LittleFS ---
+
+static std::shared_ptr<fs::FSImpl> littleFsImpl = std::make_shared<fs::FSImpl>();
+
+LittleFSFS LittleFS;
+
+LittleFSFS::LittleFSFS() : fs::FS(littleFsImpl) {
+    const char* root = getenv("NATIVE_FS_ROOT");
+    littleFsImpl->root = (root && root[0]) ? root : "native_fs";
+}
+
+bool LittleFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles, const char* partitionLabel) {
+    (void)formatOnFail;
+    (void)basePath;
+    (void)maxOpenFiles;
+    (void)partitionLabel;
+    struct stat st;
+    if (stat(littleFsImpl->root.c_str(), &st) == 0) return S_ISDIR(st.st_mode);
+    return ::mkdir(littleFsImpl->root.c_str(), 0755) == 0;
+}
+
+static void removeTree(const std::string& hostPath, bool removeSelf) {
+    DIR* dir = opendir(hostPath.c_str());
+    if (dir) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            std::string entryName = entry->d_name;
+            if (entryName == "." || entryName == "..") continue;
+            removeTree(hostPath + "/" + entryName, true);
+        }
+        closedir(dir);
+        if (removeSelf) ::rmdir(hostPath.c_str());
+    } else if (removeSelf) {
+        unlink(hostPath.c_str());
+    }
+}
+
+bool LittleFSFS::format() {
+    removeTree(littleFsImpl->root, false);
+    return true;
+}
+
+size_t LittleFSFS::totalBytes() {
+    const char* total = getenv("NATIVE_FS_TOTAL_BYTES");
+    return (total && total[0]) ? (size_t)strtoul(total, nullptr, 10) : NATIVE_FS_DEFAULT_TOTAL_BYTES;
+}
+
+// Aproximação do LittleFS: cada ficheiro e diretório ocupa blocos inteiros de 4 KiB
+static size_t usedBlocks(const std::string& hostPath) {
+    struct stat st;
+    if (stat(hostPath.c_str(), &st) != 0) return 0;
+    if (!S_ISDIR(st.st_mode)) return ((size_t)st.st_size + NATIVE_FS_BLOCK_SIZE - 1) / NATIVE_FS_BLOCK_SIZE;
+
+    size_t blocks = 1;
+    DIR* dir = opendir(hostPath.c_str());
+    if (!dir) return blocks;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string entryName = entry->d_name;
+        if (entryName == "." || entryName == "..") continue;
+        blocks += usedBlocks(hostPath + "/" + entryName);
+    }
+    closedir(dir);
+    return blocks;
+}
+
+size_t LittleFSFS::usedBytes() {
+    return usedBlocks(littleFsImpl->root) * NATIVE_FS_BLOCK_SIZE;
+}
+
+void LittleFSFS::end() {
+}
+
+const char* LittleFSFS::hostRoot() const {
+    return littleFsImpl->root.c_str();
+}
@@ -0,0 +1,21 @@
+// Wi-Fi do ambiente [env:native]: só o necessário para o setupWiFi() correr
+
+#include <WiFi.h>
+
+WiFiClass WiFi;
+
+String IPAddress::toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _bytes[0], _bytes[1], _bytes[2], _bytes[3]);
+    return String(buf);
+}
+
+size_t IPAddress::printTo(Print& p) const {
+    return p.print(toString());
+}
+
+bool WiFiClass::softAP(const char* ssid, const char* passphrase) {
+    (void)passphrase;
+    Serial.printf("[native] AP simulado: %s\n", ssid ? ssid : "");
+    return true;
+}
@@ -7,66 +7,301 @@
 #include "device_controller.h" 
 #include "data_logger.h" // Assumindo que você tem este arquivo
 #include "hub_config.h"
+#include "sync_watermark.h"
 
-#include <map> // Incluímos a biblioteca para o mapa
+#include <math.h>
+#include <vector>
 #include <LittleFS.h>
+#include <freertos/semphr.h>
 // --- Acesso às Instâncias Globais ---
 
 
 #define HUB_SERVICE_UUID        "4fafc201-1fb5-459e-8fcc-c5c9c331914b"
 #define HUB_CHARACTERISTIC_RX   "beb5483e-36e1-4688-b7f5-ea07361b26a8"
 #define HUB_CHARACTERISTIC_TX   "f48ebb2c-442a-4732-b0b3-009758a2f9b1"
+#define HUB_CHARACTERISTIC_SNAPSHOT "6e1f0a3c-5d2b-4c8e-9a7f-3b4d2c1e0f5a"
+
+// Sync em janela: registos enviados antes de esperar pelo ACK cumulativo
+#define SYNC_WINDOW_SIZE        16
+#define SYNC_ACK_TIMEOUT_MS     2000
+#define SYNC_MAX_RETRIES        5
+
+// Tarefa de sync: corre no core 0, o loop() do Arduino (amostragem e logger) fica no core 1
+#define SYNC_TASK_STACK         8192
+#define SYNC_TASK_PRIORITY      1
+#define SYNC_TASK_CORE          0
+
+// Pedidos de sync (0x02): o que falta ao cliente, tudo de novo ou um intervalo
+#define SYNC_MODE_DELTA         0 // 0x02: só o que o cliente ainda não confirmou (marca de sync)
+#define SYNC_MODE_FULL          1 // 0x02 + since 0: todo o histórico; a marca recomeça do zero
+#define SYNC_MODE_RANGE         2 // 0x02 + since [+ until]: não usa nem avança a marca
+
+// Identificador do cliente nas marcas de sync: endereço BLE ou o enviado pelo app (0x08)
+#define SYNC_CLIENT_ID_MAX      32
+
+// Bits de notificação da tarefa de sync
+#define SYNC_NOTIFY_START       (1UL << 0)
+#define SYNC_NOTIFY_ACK         (1UL << 1)
+#define SYNC_NOTIFY_CANCEL      (1UL << 2)
+
+// ATT_MTU: 23 até o cliente negociar mais; o valor de um atributo vai até 512 bytes
+#define BLE_DEFAULT_MTU         23
+#define BLE_LOCAL_MTU           517
+#define BLE_MAX_NOTIFY_PAYLOAD  512
+
+// Notificações em tempo real: payload montado uma vez por sensor em setupBLE(), só o valor muda
+#define BLE_SENSOR_PAYLOAD_MAX  128
+#define BLE_RT_FORMAT_JSON      0 // {"sensorId":..,"value":..,"unit":..}\n
+#define BLE_RT_FORMAT_BINARY    1 // float32 LE: a característica já identifica o sensor (0x09 0x01)
+
+// Snapshot: todos os sensores numa notificação por ciclo ("ble.snapshot" em hub_config.json)
+#define BLE_SNAPSHOT_VERSION    1
+// Handles de cada característica de sensor: declaração, valor e descritor BLE2902
+#define BLE_SENSOR_HANDLES      3
+#define BLE_SENSOR_SERVICE_MIN_HANDLES 30
+
+/**
+ * @brief Cabeçalho do snapshot, seguido de um float32 LE por sensor na ordem de "sensors" da config (0x20).
+ * configCrc muda sempre que os sensores (ids, unidades ou ordem) mudam: o app só decodifica
+ * por posição se for igual ao "config_crc" da config que tem.
+ */
+struct __attribute__((packed)) BleSnapshotHeader {
+    uint8_t version;
+    uint8_t count;
+    uint32_t configCrc;
+    uint32_t timestamp; // epoch em segundos
+};
 
 extern DeviceController meuDevice;
 
 extern bool isSystemReady;
 
 BLECharacteristic *pTxCharacteristic;
-std::map<String, BLECharacteristic*> characteristicMap;
+
+/**
+ * @brief Característica e payload de um sensor, na ordem de getSensors() (o índice fica no Sensor).
+ * O prefixo {"sensorId":"<id>","value": fica no início de 'payload'; cada notificação escreve
+ * o valor a seguir e copia o sufixo ,"unit":"<unidade>"}\n, sem ArduinoJson nem String.
+ */
+struct BleSensorSlot {
+    BLECharacteristic* pChar;
+    uint8_t prefixLen;
+    uint8_t suffixLen;
+    char suffix[48];
+    char payload[BLE_SENSOR_PAYLOAD_MAX];
+};
+std::vector<BleSensorSlot> sensorSlots;
+volatile uint8_t realTimeFormat = BLE_RT_FORMAT_JSON;
+BLECharacteristic* pSnapshotCharacteristic = nullptr;
+std::vector<uint8_t> snapshotPayload; // cabeçalho + valores, alocado uma vez em setupBLE()
+uint32_t snapshotConfigCrc = 0;
+bool snapshotDirty = false; // algum sensor notificou desde o último snapshot
+unsigned long lastSnapshotMillis = 0;
 bool deviceConnected = false;
-volatile bool syncRequested = false; 
+uint16_t peerConnId = 0;
+volatile uint16_t peerMtu = BLE_DEFAULT_MTU;
+TaskHandle_t syncTaskHandle = nullptr;
+// Dono do pTxCharacteristic: a syncTask durante todo o sync, o loopBLE em cada resposta JSON
+static SemaphoreHandle_t txMutex = nullptr;
 volatile time_t syncSinceTimestamp = 0;
+volatile time_t syncUntilTimestamp = 0;
+volatile uint8_t syncMode = SYNC_MODE_DELTA;
+char syncClientId[SYNC_CLIENT_ID_MAX + 1] = "";
 volatile bool realTimeStreamActive = true;
 unsigned long lastRealTimeSent = 0;
-bool ackReceived = false;
-volatile bool syncCancelled = false;
+// ACK estendido (0x01 + uint32 LE): maior seq recebida sem lacunas
+volatile uint32_t ackSeq = 0;
+volatile bool ackHasSeq = false;
 volatile bool configRequested = false; 
+volatile bool notifyAllRequested = false;
+// Pedido de amostras recentes (0x10): últimas N ou desde 'since'
+volatile bool recentRequested = false;
+volatile uint8_t recentLastN = 0;
+volatile time_t recentSince = 0;
+
+// Pedido de agregados (0x11): desde 'since', de uma janela ou de todas
+volatile bool rollupRequested = false;
+volatile time_t rollupSince = 0;
+volatile uint32_t rollupWindow = 0;
+#define BLE_ROLLUP_MAX_RECORDS 64 // por resposta; o resto fica para 0x11 + "next"
+
+// Amostras por sensor quando o 0x10 não indica N (cada sensor guarda até SENSOR_RING_CAPACITY)
+#define BLE_RECENT_DEFAULT_N 16
 
 // --- Protótipo da função de sync ---
 void handleSyncProcess();
+static void syncTask(void* param);
+
+// Chamado pelos callbacks BLE; a tarefa de sync acorda só com estes eventos
+static void notifySyncTask(uint32_t bits) {
+    if (syncTaskHandle) xTaskNotify(syncTaskHandle, bits, eSetBits);
+}
 
 
 // --- Callbacks (do seu arquivo original) ---
 class MyServerCallbacks: public BLEServerCallbacks {
-    void onConnect(BLEServer* pServer) { deviceConnected = true; Serial.println("Dispositivo BLE conectado."); }
+    void onConnect(BLEServer* pServer, esp_ble_gatts_cb_param_t* param) {
+      deviceConnected = true;
+      peerConnId = param->connect.conn_id;
+      const uint8_t* bda = param->connect.remote_bda;
+      snprintf(syncClientId, sizeof(syncClientId), "%02x:%02x:%02x:%02x:%02x:%02x",
+               bda[0], bda[1], bda[2], bda[3], bda[4], bda[5]);
+      peerMtu = pServer->getPeerMTU(peerConnId);
+      if (peerMtu < BLE_DEFAULT_MTU) peerMtu = BLE_DEFAULT_MTU;
+      snapshotDirty = true; // o app recebe logo o estado atual
+      Serial.printf("Dispositivo BLE conectado (MTU %u).\n", peerMtu);
+    }
+    void onMtuChanged(BLEServer* pServer, esp_ble_gatts_cb_param_t* param) {
+      peerMtu = param->mtu.mtu;
+      Serial.printf("MTU BLE negociado: %u\n", peerMtu);
+    }
     void onDisconnect(BLEServer* pServer) {
-      deviceConnected = false; syncRequested = false; realTimeStreamActive = false;
+      deviceConnected = false; realTimeStreamActive = false;
+      realTimeFormat = BLE_RT_FORMAT_JSON; // o próximo app volta a negociar
+      notifySyncTask(SYNC_NOTIFY_CANCEL);
+      peerMtu = BLE_DEFAULT_MTU;
       Serial.println("Dispositivo BLE desconectado.");
       Serial.println("Recomeçando advertising...");
       BLEDevice::startAdvertising();
     }
 };
 
+// Bytes úteis por notificação no MTU atual (3 bytes vão para o cabeçalho ATT)
+static size_t notifyPayloadSize() {
+    size_t payload = peerMtu - 3;
+    return payload > BLE_MAX_NOTIFY_PAYLOAD ? BLE_MAX_NOTIFY_PAYLOAD : payload;
+}
+
+/**
+ * @brief Empacota frames [uint16 LE comprimento][payload] em notificações do tamanho do MTU.
+ * Um frame pode continuar na notificação seguinte: o app concatena as notificações
+ * e separa os registos pelos prefixos de comprimento.
+ */
+class BleFramePacker {
+public:
+    explicit BleFramePacker(BLECharacteristic* pChar) : _pChar(pChar), _used(0), _cap(notifyPayloadSize()) {}
+
+    void pushFrame(const uint8_t* data, size_t len) {
+        uint8_t prefix[2] = { (uint8_t)(len & 0xFF), (uint8_t)(len >> 8) };
+        _write(prefix, sizeof(prefix));
+        _write(data, len);
+    }
+
+    // Envia a notificação parcial pendente
+    void flush() {
+        if (_used == 0) return;
+        _pChar->setValue(_buffer, _used);
+        _pChar->notify();
+        _used = 0;
+    }
+
+private:
+    void _write(const uint8_t* data, size_t len) {
+        while (len > 0) {
+            size_t n = min(len, _cap - _used);
+            memcpy(_buffer + _used, data, n);
+            _used += n;
+            data += n;
+            len -= n;
+            if (_used == _cap) flush();
+        }
+    }
+
+    BLECharacteristic* _pChar;
+    uint8_t _buffer[BLE_MAX_NOTIFY_PAYLOAD];
+    size_t _used;
+    size_t _cap;
+};
+
+static uint32_t readUint32LE(const std::string& value, size_t pos) {
+    return (uint32_t)(uint8_t)value[pos] |
+           ((uint32_t)(uint8_t)value[pos + 1] << 8) |
+           ((uint32_t)(uint8_t)value[pos + 2] << 16) |
+           ((uint32_t)(uint8_t)value[pos + 3] << 24);
+}
+
 class MyCallbacks: public BLECharacteristicCallbacks {
     void onWrite(BLECharacteristic *pCharacteristic) {
       std::string value = pCharacteristic->getValue();
       if (value.length() == 1) { // Apenas comandos de 1 byte
         switch(value[0]) {
-          case 0x01: ackReceived = true; break;
-          case 0x02: syncRequested = true; Serial.println("📲 Comando de sync total (0x02) recebido!"); break;
+          case 0x01: ackHasSeq = false; notifySyncTask(SYNC_NOTIFY_ACK); break;
+          case 0x02:
+            syncSinceTimestamp = 0;
+            syncUntilTimestamp = 0;
+            syncMode = SYNC_MODE_DELTA;
+            notifySyncTask(SYNC_NOTIFY_START);
+            Serial.println("📲 Comando de sync (0x02) recebido: registos ainda não confirmados.");
+            break;
           case 0x03: 
             realTimeStreamActive = true;
+            notifyAllRequested = true; // no loopBLE(): o payload de cada sensor só é escrito no core do loop()
             Serial.println("📲 Comando para INICIAR fluxo em tempo real recebido.");
-            for (Sensor* s : meuDevice.getSensors()) {
-              if (s) s->notify();
-            }
             break;
 
             case 0x05: realTimeStreamActive = false; Serial.println("📲 Comando para PARAR fluxo em tempo real recebido."); break;
-          case 0x06: Serial.println("Comando para Deletar recebido."); deleteLogFiles(); break;
-          case 0x07: syncCancelled = true; Serial.println("📲 Comando para CANCELAR sync (0x07) recebido!"); break;
+          case 0x06: {
+            // Só os dias que este cliente já confirmou: nada se perde se o app apagar antes de guardar tudo
+            Serial.println("Comando para Deletar recebido.");
+            notifySyncTask(SYNC_NOTIFY_CANCEL); // não apaga por baixo de um sync em curso
+            SyncWatermark mark;
+            if (!loadSyncWatermark(syncClientId, mark)) {
+              Serial.printf("⚠️ %s sem sync confirmado: nada apagado.\n", syncClientId);
+              break;
+            }
+            uint32_t days = deleteLogDaysBefore(mark.day);
+            Serial.printf("🗑️ %u dia(s) confirmados por %s apagados.\n", (unsigned)days, syncClientId);
+            break;
+          }
+          case 0x07: notifySyncTask(SYNC_NOTIFY_CANCEL); Serial.println("📲 Comando para CANCELAR sync (0x07) recebido!"); break;
+          case 0x10:
+            recentLastN = BLE_RECENT_DEFAULT_N;
+            recentSince = 0;
+            recentRequested = true;
+            break;
+          case 0x11:
+            rollupSince = 0;
+            rollupWindow = 0;
+            rollupRequested = true;
+            break;
           case 0x20: configRequested = true; Serial.println("📲 Comando para pedir config (0x20) recebido!"); break;
         }
+      } else if (value[0] == 0x06 && value.length() == 2 && (uint8_t)value[1] == 0xFF) {
+        // Apagar tudo, confirmado ou não (comportamento antigo do 0x06)
+        Serial.println("Comando para Deletar todo o histórico recebido.");
+        notifySyncTask(SYNC_NOTIFY_CANCEL);
+        deleteLogFiles();
+      } else if (value[0] == 0x09 && value.length() == 2 && (uint8_t)value[1] <= BLE_RT_FORMAT_BINARY) {
+        // Formato das notificações em tempo real: 0x09 0x00 JSON (padrão), 0x09 0x01 float32 LE
+        realTimeFormat = (uint8_t)value[1];
+        Serial.printf("📲 Formato do tempo real: %s\n", realTimeFormat == BLE_RT_FORMAT_BINARY ? "binário" : "JSON");
+      } else if (value[0] == 0x08 && value.length() > 1 && value.length() <= SYNC_CLIENT_ID_MAX + 1) {
+        // Identificador estável do app: o endereço BLE dos telemóveis muda com o tempo
+        memcpy(syncClientId, value.data() + 1, value.length() - 1);
+        syncClientId[value.length() - 1] = '\0';
+        Serial.printf("📲 Cliente de sync: %s\n", syncClientId);
+      } else if (value[0] == 0x01 && value.length() == 5) {
+        ackSeq = readUint32LE(value, 1);
+        ackHasSeq = true;
+        notifySyncTask(SYNC_NOTIFY_ACK);
+      } else if (value[0] == 0x10 && (value.length() == 2 || value.length() == 5)) {
+        // Amostras recentes: 0x10 + N (uint8) ou 0x10 + since (uint32 LE)
+        recentLastN = (value.length() == 2) ? (uint8_t)value[1] : 0;
+        recentSince = (value.length() == 5) ? readUint32LE(value, 1) : 0;
+        recentRequested = true;
+      } else if (value[0] == 0x11 && (value.length() == 5 || value.length() == 9)) {
+        // Agregados: 0x11 + since (uint32 LE) [+ janela em segundos (uint32 LE)]
+        rollupSince = readUint32LE(value, 1);
+        rollupWindow = (value.length() == 9) ? readUint32LE(value, 5) : 0;
+        rollupRequested = true;
+      } else if (value[0] == 0x02 && (value.length() == 5 || value.length() == 9)) {
+        // Sync por intervalo: 0x02 + since (uint32 LE) [+ until (uint32 LE)]
+        syncSinceTimestamp = readUint32LE(value, 1);
+        syncUntilTimestamp = (value.length() == 9) ? readUint32LE(value, 5) : 0;
+        syncMode = (syncSinceTimestamp == 0 && syncUntilTimestamp == 0) ? SYNC_MODE_FULL : SYNC_MODE_RANGE;
+        notifySyncTask(SYNC_NOTIFY_START);
+        Serial.printf("📲 Comando de sync (0x02) desde %lu até %lu recebido!\n",
+                      (unsigned long)syncSinceTimestamp, (unsigned long)syncUntilTimestamp);
       }
     }
 };
@@ -87,6 +322,41 @@ void printCharacteristicInfo(BLECharacteristic* pChar) {
 
 }
 
+/**
+ * @brief Monta o prefixo e o sufixo JSON do sensor (com o escape do ArduinoJson), uma só vez.
+ * Se o id e a unidade não couberem no payload, o sensor fica sem notificações.
+ */
+static void initSensorSlot(BleSensorSlot& slot, BLECharacteristic* pChar, const String& sensorId, const String& unit) {
+    slot.pChar = nullptr;
+    slot.prefixLen = 0;
+    slot.suffixLen = 0;
+
+    StaticJsonDocument<128> doc;
+    doc["sensorId"] = sensorId;
+    size_t idLen = serializeJson(doc, slot.payload, sizeof(slot.payload)); // {"sensorId":"<id>"}
+    doc.clear();
+    doc["unit"] = unit;
+    char unitJson[sizeof(slot.suffix)];
+    size_t unitLen = serializeJson(doc, unitJson, sizeof(unitJson)); // {"unit":"<unidade>"}
+
+    static const char valueKey[] = ",\"value\":";
+    size_t prefixLen = idLen - 1 + sizeof(valueKey) - 1;
+    // Pior caso do valor: "%.7g" de um float negativo com expoente (15 caracteres)
+    if (idLen < 2 || unitLen < 2 || unitLen + 1 > sizeof(slot.suffix) ||
+        prefixLen + 16 + unitLen + 1 > sizeof(slot.payload)) {
+        Serial.printf("⚠️ Id ou unidade de %s longos demais para a notificação BLE.\n", sensorId.c_str());
+        return;
+    }
+
+    memcpy(slot.payload + idLen - 1, valueKey, sizeof(valueKey) - 1); // troca o '}' final
+    slot.suffix[0] = ',';
+    memcpy(slot.suffix + 1, unitJson + 1, unitLen - 1); // sem o '{' inicial
+    slot.suffix[unitLen] = '\n';
+    slot.prefixLen = prefixLen;
+    slot.suffixLen = unitLen + 1;
+    slot.pChar = pChar;
+}
+
 void setupBLE(DeviceController& meuDevice) {
     if (!meuDevice.isReady()) {
         Serial.println("BLE Setup abortado: DeviceController não está pronto.");
@@ -100,6 +370,7 @@ void setupBLE(DeviceController& meuDevice) {
 
     // Inicializa o BLE
     BLEDevice::init("ESP32_BLE_01");
+    BLEDevice::setMTU(BLE_LOCAL_MTU); // permite ao cliente negociar notificações maiores
     BLEServer* pServer = BLEDevice::createServer();
     pServer->setCallbacks(new MyServerCallbacks());
 
@@ -120,24 +391,42 @@ void setupBLE(DeviceController& meuDevice) {
     );
     pTxCharacteristic->addDescriptor(new BLE2902());
 
+    const BleSnapshotConfig& snapshotConfig = HubConfig::getInstance().getBleSnapshot();
+    if (snapshotConfig.enabled) {
+        pSnapshotCharacteristic = pHubService->createCharacteristic(
+            HUB_CHARACTERISTIC_SNAPSHOT,
+            BLECharacteristic::PROPERTY_NOTIFY | BLECharacteristic::PROPERTY_READ
+        );
+        pSnapshotCharacteristic->addDescriptor(new BLE2902());
+    }
+
     pHubService->start();
 
     // ===========================
     // Serviço Sensores
     // ===========================
+    const auto& sensors = meuDevice.getSensors();
+    uint32_t sensorHandles = 1 + sensors.size() * BLE_SENSOR_HANDLES;
     BLEService* pSensorService = pServer->createService(
         BLEUUID(sensorServiceUuid.c_str()), 
-        30  // aumenta o limite de handlers
+        max(sensorHandles, (uint32_t)BLE_SENSOR_SERVICE_MIN_HANDLES)  // cabe uma característica por sensor
     );
 
     Serial.println("Criando características de dados dos sensores dinamicamente...");
-    const auto& sensors = meuDevice.getSensors();
     for (Sensor* s : sensors) {
         if (!s) continue;
 
         String sensorId = s->getSensorId();
         String charUuid = s->getCharacteristicUuid();
 
+        // O sensor guarda o índice (também a posição no snapshot); notifySensorValue() não procura pelo id
+        s->setBleSlot(sensorSlots.size());
+        sensorSlots.push_back(BleSensorSlot());
+        sensorSlots.back().pChar = nullptr;
+        snapshotConfigCrc = logCrc32(snapshotConfigCrc, (const uint8_t*)sensorId.c_str(), sensorId.length() + 1);
+        snapshotConfigCrc = logCrc32(snapshotConfigCrc, (const uint8_t*)s->getUnit().c_str(), s->getUnit().length() + 1);
+        if (!snapshotConfig.perSensor) continue; // só o snapshot
+
         BLECharacteristic* pChar = pSensorService->createCharacteristic(
             charUuid.c_str(),
             BLECharacteristic::PROPERTY_NOTIFY | BLECharacteristic::PROPERTY_READ
@@ -150,22 +439,28 @@ void setupBLE(DeviceController& meuDevice) {
             Serial.printf("✅ BLE2902 adicionado em %s\n", sensorId.c_str());
         }
 
-        // Salva no mapa para notificação futura
-        characteristicMap[sensorId] = pChar;
+        initSensorSlot(sensorSlots.back(), pChar, sensorId, s->getUnit());
 
         Serial.printf("🔹 Característica criada para sensor %s (UUID: %s)\n",
                       sensorId.c_str(), charUuid.c_str());
     }
 
     Serial.println("🧩 Resumo das características criadas:");
-    for (auto const& entry : characteristicMap) {
+    for (Sensor* s : sensors) {
+        if (!s || s->getBleSlot() < 0 || !sensorSlots[s->getBleSlot()].pChar) continue;
         Serial.printf("   ↳ SensorID: %s | Char UUID: %s\n",
-                      entry.first.c_str(),
-                      entry.second->getUUID().toString().c_str());
+                      s->getSensorId().c_str(),
+                      sensorSlots[s->getBleSlot()].pChar->getUUID().toString().c_str());
     }
 
     pSensorService->start();
 
+    if (pSnapshotCharacteristic) {
+        snapshotPayload.assign(sizeof(BleSnapshotHeader) + sensorSlots.size() * sizeof(float), 0);
+        Serial.printf("🧩 Snapshot de %u sensores em %u bytes (config %08lx).\n", (unsigned)sensorSlots.size(),
+                      (unsigned)snapshotPayload.size(), (unsigned long)snapshotConfigCrc);
+    }
+
     // ===========================
     // Advertising
     // ===========================
@@ -175,31 +470,197 @@ void setupBLE(DeviceController& meuDevice) {
     BLEDevice::startAdvertising();
 
     Serial.println("Servidor BLE iniciado com HUB + Sensores.");
+
+    // O sync pode durar minutos: corre na sua própria tarefa para não parar a amostragem
+    if (!txMutex) txMutex = xSemaphoreCreateMutex();
+    if (!syncTaskHandle) {
+        xTaskCreatePinnedToCore(syncTask, "bleSync", SYNC_TASK_STACK, nullptr,
+                                SYNC_TASK_PRIORITY, &syncTaskHandle, SYNC_TASK_CORE);
+    }
 }
-bool waitForAck() {
-  long startTime = millis();
-  ackReceived = false;
-  while(!ackReceived) {
-    if (!deviceConnected) return false;
-    if (millis() - startTime > 2000) {
-      Serial.println("Timeout esperando por ACK.");
-      return false;
+/**
+ * @brief Espera por ACK ou cancelamento (desconexão/0x07) sem polling.
+ * @return Bits SYNC_NOTIFY_ACK/SYNC_NOTIFY_CANCEL recebidos, ou 0 no timeout.
+ */
+static uint32_t waitForSyncEvent(uint32_t timeoutMs) {
+    unsigned long startTime = millis();
+    unsigned long elapsed;
+    while ((elapsed = millis() - startTime) < timeoutMs) {
+        uint32_t bits = 0;
+        if (xTaskNotifyWait(0, SYNC_NOTIFY_ACK | SYNC_NOTIFY_CANCEL, &bits,
+                            pdMS_TO_TICKS(timeoutMs - elapsed)) != pdTRUE) {
+            break;
+        }
+        // Um novo 0x02 a meio do sync deixa o bit START no valor da notificação (a syncTask corre-o a seguir);
+        // aqui só interessam ACK e cancelamento
+        bits &= SYNC_NOTIFY_ACK | SYNC_NOTIFY_CANCEL;
+        if (bits) return bits;
+    }
+    Serial.println("Timeout esperando por ACK.");
+    return 0;
+}
+
+// Fica à espera de pedidos de sync (0x02) e corre cada um até ao fim fora do loop()
+static void syncTask(void* param) {
+    for (;;) {
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, SYNC_NOTIFY_START, &bits, portMAX_DELAY);
+
+        while ((bits & SYNC_NOTIFY_START) && deviceConnected) {
+            // Descarta ACKs e cancelamentos que chegaram antes do pedido
+            ulTaskNotifyValueClear(nullptr, SYNC_NOTIFY_ACK | SYNC_NOTIFY_CANCEL);
+            realTimeStreamActive = false;
+            xSemaphoreTake(txMutex, portMAX_DELAY); // espera pela resposta JSON que o loopBLE esteja a enviar
+            handleSyncProcess();
+            xSemaphoreGive(txMutex);
+
+            // O xTaskNotifyWait do sync já consumiu a notificação de um 0x02 recebido entretanto:
+            // só o bit fica, por isso o próximo sync arranca já em vez de esperar por outro evento
+            bits = ulTaskNotifyValueClear(nullptr, SYNC_NOTIFY_START);
+        }
+    }
+}
+
+/**
+ * @brief Posição de leitura de cada registo ainda não confirmado, para retransmitir
+ * a partir do último ACK sem reler os ficheiros desde o início.
+ */
+struct SyncWindowSlot {
+    uint16_t fileIndex;
+    uint32_t offset;   // posição antes do registo
+    uint32_t ordinal;  // registos do ficheiro antes deste
+    uint32_t end;      // posição depois do registo (a marca de sync quando for confirmado)
+};
+
+// Cursor de leitura sobre os ficheiros do sync
+struct SyncCursor {
+    std::vector<SyncFilePlan>* files;
+    size_t fileIndex;
+    LogFileReader reader;
+    uint32_t ordinal;
+    time_t since;
+    time_t until;
+
+    // Abre o ficheiro e, com 'skipAcked', salta o que o cliente já confirmou
+    bool openFile(size_t index, bool skipAcked) {
+        LogReadLock lock;
+        reader.close();
+        fileIndex = index;
+        ordinal = 0;
+        if (fileIndex >= files->size()) return false;
+
+        SyncFilePlan& file = (*files)[fileIndex];
+        String path = resolveLogFilePath(file.path); // pode ter sido compactado depois do plano
+        if (!reader.open(path)) return false;
+        file.openedCompression = logCompressionOf(path);
+        reader.setTimeRange(since, until); // salta pelo índice até 'since'
+        if (!skipAcked || file.startRecords == 0) return true;
+
+        // Na mesma forma, a posição guardada serve; compactado entretanto, conta os registos
+        if (file.mark && file.mark->position != 0 && file.mark->compression == file.openedCompression) {
+            reader.seek(file.mark->position);
+        } else {
+            char line[LOG_LINE_MAX];
+            for (uint32_t i = 0; i < file.startRecords && reader.readNextLine(line, sizeof(line)) > 0; i++) {}
+        }
+        ordinal = file.startRecords;
+        return true;
+    }
+
+    // Lê o registo 'seq', avançando de ficheiro quando necessário
+    size_t next(char* line, size_t len, SyncWindowSlot& slot, uint32_t seq) {
+        while (fileIndex < files->size()) {
+            if (reader.isOpen()) {
+                // O logger pode estar a acrescentar a este ficheiro: cada leitura é feita com o mutex
+                LogReadLock lock;
+                slot.fileIndex = fileIndex;
+                slot.offset = reader.position();
+                slot.ordinal = ordinal;
+                size_t n = reader.readNextLine(line, len);
+                if (n > 0) {
+                    slot.end = reader.position();
+                    ordinal++;
+                    return n;
+                }
+                SyncFilePlan& file = (*files)[fileIndex];
+                file.eof = true;
+                file.eofSeq = seq - 1;
+                file.eofPosition = reader.position();
+            }
+            openFile(fileIndex + 1, true);
+        }
+        return 0;
+    }
+
+    // Volta a posicionar o cursor no registo guardado em 'slot'
+    void rewind(const SyncWindowSlot& slot) {
+        if (slot.fileIndex != fileIndex || !reader.isOpen()) openFile(slot.fileIndex, false);
+        reader.seek(slot.offset);
+        ordinal = slot.ordinal;
+    }
+};
+
+// Com 'packer', o registo vira um frame; sem ele, uma notificação terminada em '\n'
+static void sendSyncDataRecord(uint32_t seq, const char* line, size_t len, BleFramePacker* packer) {
+    // {"type":"data","seq":N, + restante da linha JSON (sem a chaveta inicial) + '\n'
+    char packet[LOG_LINE_MAX + 40];
+    int n = snprintf(packet, sizeof(packet), "{\"type\":\"data\",\"seq\":%lu,%.*s\n",
+                     (unsigned long)seq, (int)(len - 1), line + 1);
+    if (n < 0 || (size_t)n >= sizeof(packet)) return;
+    if (packer) {
+        packer->pushFrame((uint8_t*)packet, n - 1);
+        return;
+    }
+    pTxCharacteristic->setValue((uint8_t*)packet, n);
+    pTxCharacteristic->notify();
+}
+
+// Grava até onde o cliente confirmou, também num sync interrompido (o que falta vai no próximo)
+static void commitSyncWatermark(const String& clientId, SyncWatermark& mark, const std::vector<SyncFilePlan>& files,
+                                uint32_t ackedSeq, uint32_t generation) {
+    LogReadLock lock; // a geração não muda entre a verificação e a gravação
+    if (generation != syncWatermarkGeneration()) return; // histórico apagado ou agregado durante o sync
+    advanceSyncWatermark(mark, files, ackedSeq);
+    if (saveSyncWatermark(clientId, mark)) {
+        Serial.printf("🔖 Marca de sync de %s: dias até %lu confirmados, %u ficheiro(s) em curso.\n", clientId.c_str(),
+                      (unsigned long)mark.day, (unsigned)mark.files.size());
     }
-    delay(10);
-  }
-  return true;
 }
 
 void handleSyncProcess() {
     Serial.println("\n--- ESP32: Iniciando sync de MÚLTIPLOS FICHEIROS via BLE ---");
 
-    int totalRecords = getTotalRecordsInAllFiles();
-    Serial.printf("ℹ️ ESP32: Encontrados %d registros no total para enviar.\n", totalRecords);
+    // Garante que os registos ainda no buffer de escrita entram na sincronização
+    flushLogs();
+
+    time_t since = syncSinceTimestamp;
+    time_t until = syncUntilTimestamp;
+    const uint8_t mode = syncMode;
+    const String clientId = syncClientId;
+    const uint32_t generation = syncWatermarkGeneration();
+
+    // Ficheiros a enviar, do catálogo em RAM e em ordem cronológica: com marca, só o que falta confirmar
+    SyncWatermark mark;
+    std::vector<SyncFilePlan> files;
+    uint32_t totalRecords = 0;
+    if (mode == SYNC_MODE_RANGE) {
+        files = planSyncRange(since, until);
+        totalRecords = countRecordsInRange(since, until);
+    } else {
+        if (mode == SYNC_MODE_DELTA) loadSyncWatermark(clientId, mark);
+        files = planSyncDelta(mark, totalRecords);
+    }
+    Serial.printf("ℹ️ ESP32: Encontrados %lu registros para enviar a %s.\n", (unsigned long)totalRecords, clientId.c_str());
 
     // 1. Envia SOT
-    StaticJsonDocument<100> sotDoc;
+    StaticJsonDocument<128> sotDoc;
     sotDoc["type"] = "SOT";
     sotDoc["records"] = totalRecords;
+    sotDoc["window"] = SYNC_WINDOW_SIZE;
+    sotDoc["mtu"] = peerMtu;
+    if (mode == SYNC_MODE_DELTA) sotDoc["delta"] = true;
+    if (since != 0) sotDoc["since"] = (uint32_t)since;
+    if (until != 0) sotDoc["until"] = (uint32_t)until;
     String sotStr;
     serializeJson(sotDoc, sotStr);
 
@@ -209,100 +670,147 @@ void handleSyncProcess() {
     pTxCharacteristic->setValue(sotStr.c_str());
     pTxCharacteristic->notify();
 
-    if (!waitForAck()) {
+    if (waitForSyncEvent(SYNC_ACK_TIMEOUT_MS) != SYNC_NOTIFY_ACK) {
         Serial.println("❌ Falha no ACK para o SOT ou nenhum registro encontrado. Abortando.");
         return;
     }
-    Serial.println("✅ ACK para SOT recebido. Iniciando envio de dados...");
 
-    int totalCount = 0;
-    File root = LittleFS.open(LOG_DIR);
-    if (!root || !root.isDirectory()) {
-        Serial.println("❌ Falha ao abrir LOG_DIR ou não é diretório.");
-        return ;
-    }
+    // Quem responde ao SOT com ACK estendido recebe em janela e em frames empacotados pelo MTU;
+    // ACK de 1 byte mantém o envio registo a registo, um por notificação
+    const bool windowed = ackHasSeq;
+    const uint32_t window = windowed ? SYNC_WINDOW_SIZE : 1;
+    BleFramePacker framePacker(pTxCharacteristic);
+    BleFramePacker* packer = windowed ? &framePacker : nullptr;
+    Serial.printf("✅ ACK para SOT recebido. Iniciando envio de dados (janela %lu, MTU %u)...\n",
+                  (unsigned long)window, peerMtu);
+
+    SyncCursor cursor;
+    cursor.files = &files;
+    cursor.since = since;
+    cursor.until = until;
+    cursor.openFile(0, true);
+
+    SyncWindowSlot slots[SYNC_WINDOW_SIZE];
+    char line[LOG_LINE_MAX];
+    uint32_t nextSeq = 1;   // próximo registo a enviar
+    uint32_t ackedSeq = 0;  // maior seq confirmada sem lacunas
+    bool exhausted = false;
+    bool completed = false;
+    int retries = 0;
+
+    while (true) {
+        // 2. Enche a janela sem esperar por ACK
+        while (!exhausted && nextSeq - ackedSeq <= window) {
+            SyncWindowSlot& slot = slots[nextSeq % SYNC_WINDOW_SIZE];
+            size_t len = cursor.next(line, sizeof(line), slot, nextSeq);
+            if (len == 0) {
+                exhausted = true;
+                break;
+            }
+            sendSyncDataRecord(nextSeq, line, len, packer);
+            nextSeq++;
+        }
+        if (packer) packer->flush();
+
+        if (exhausted && ackedSeq + 1 == nextSeq) { // tudo confirmado
+            completed = true;
+            break;
+        }
 
-    File dir = root.openNextFile();
-    while(dir) {
-        if(dir.isDirectory()) {
-            Serial.printf("📁 Diretório: %s\n", dir.name());
-
-            File f = dir.openNextFile();
-            while(f) {
-                if(!f.isDirectory()) {
-                    Serial.printf("   📄 Arquivo: %s\n", f.name());
-
-                    while(f.available()) {
-                        String line = f.readStringUntil('\n');
-                        Serial.printf("      📝 Linha lida: %s\n", line.c_str());
-                        if(line.length() > 2){
-                          String jsonStr = "{\"type\":\"data\"," + line.substring(1);
-
-                          // ** Adiciona quebra de linha ao JSON antes de enviar **
-                          if (!jsonStr.endsWith("\n")) jsonStr += '\n';
-
-                          Serial.printf("JSOON: %s\n", jsonStr.c_str());
-                            pTxCharacteristic->setValue(jsonStr.c_str());
-                            pTxCharacteristic->notify();
-
-                            if (!waitForAck()) {
-                                Serial.println("❌ Timeout ou falha no ACK. Interrompendo envio.");
-                                f.close();
-                                dir.close();
-                                root.close();
-                                return;
-                            }
-                        }
-                    }
+        // 3. Espera pelo ACK cumulativo
+        unsigned long startTime = millis();
+        bool progressed = false;
+        bool cancelled = false;
+        while (!progressed) {
+            unsigned long elapsed = millis() - startTime;
+            uint32_t events = elapsed < SYNC_ACK_TIMEOUT_MS ? waitForSyncEvent(SYNC_ACK_TIMEOUT_MS - elapsed) : 0;
+            if ((events & SYNC_NOTIFY_CANCEL) || !deviceConnected) {
+                cancelled = true;
+                break;
+            }
+            if (!(events & SYNC_NOTIFY_ACK)) break; // timeout
+
+            // ACK de 1 byte confirma tudo o que já foi enviado (janela 1)
+            uint32_t seq = ackHasSeq ? ackSeq : nextSeq - 1;
+            if (seq > ackedSeq && seq < nextSeq) {
+                // Os registos confirmados avançam a marca do ficheiro de onde vieram
+                for (uint32_t s = ackedSeq + 1; s <= seq; s++) {
+                    const SyncWindowSlot& slot = slots[s % SYNC_WINDOW_SIZE];
+                    files[slot.fileIndex].ackedRecords = slot.ordinal + 1;
+                    files[slot.fileIndex].ackedPosition = slot.end;
                 }
-                f.close();
-                f = dir.openNextFile();
+                ackedSeq = seq;
+                progressed = true;
             }
         }
-        dir.close();
-        dir = root.openNextFile();
+        if (cancelled) {
+            Serial.println("❌ Sync interrompido (desconexão ou cancelamento).");
+            break;
+        }
+
+        if (progressed) {
+            retries = 0;
+            continue;
+        }
+
+        // 4. Timeout: retransmite a partir do primeiro registo não confirmado
+        if (++retries > SYNC_MAX_RETRIES) {
+            Serial.println("❌ Timeout ou falha no ACK. Interrompendo envio.");
+            break;
+        }
+        Serial.printf("⚠️ Timeout no ACK: retransmitindo desde seq %lu\n", (unsigned long)(ackedSeq + 1));
+        cursor.rewind(slots[(ackedSeq + 1) % SYNC_WINDOW_SIZE]);
+        nextSeq = ackedSeq + 1;
+        exhausted = false;
     }
-    root.close();
-    Serial.printf("ℹ️ Total de registros encontrados: %d\n", totalCount);
+    cursor.reader.close();
+    if (mode != SYNC_MODE_RANGE) commitSyncWatermark(clientId, mark, files, ackedSeq, generation);
+    if (!completed) return;
+    Serial.printf("ℹ️ Total de registros enviados: %lu\n", (unsigned long)ackedSeq);
 
-    // 3. Envia EOT
+    // 5. Envia EOT
     StaticJsonDocument<100> eotDoc;
     eotDoc["type"] = "EOT";
+    eotDoc["records"] = ackedSeq;
     String eotStr;
     serializeJson(eotDoc, eotStr);
 
-    // ** Adiciona quebra de linha ao JSON antes de enviar **
-    if (!eotStr.endsWith("\n")) eotStr += '\n';
+    if (packer) {
+        packer->pushFrame((const uint8_t*)eotStr.c_str(), eotStr.length());
+        packer->flush();
+    } else {
+        // ** Adiciona quebra de linha ao JSON antes de enviar **
+        if (!eotStr.endsWith("\n")) eotStr += '\n';
 
-    pTxCharacteristic->setValue(eotStr.c_str());
-    pTxCharacteristic->notify();
+        pTxCharacteristic->setValue(eotStr.c_str());
+        pTxCharacteristic->notify();
+    }
 
     Serial.println("--- ESP32: Sincronização de múltiplos ficheiros finalizada. ---");
 }
-void notifySensorValue(const String& sensor_id, float value, const String& unit) {
-   // if (!deviceConnected) return;
-    //value = random(100,300)/10;
-    // Cria JSON
-    StaticJsonDocument<128> doc;
-    doc["sensorId"] = sensor_id;
-    doc["value"] = value;
-    doc["unit"] = unit;
-
-    String jsonStr;
-    serializeJson(doc, jsonStr);
-
-    // ** Adiciona quebra de linha ao JSON antes de enviar **
-    if (!jsonStr.endsWith("\n")) jsonStr += '\n';
+void notifySensorValue(int bleSlot, float value) {
+    if (bleSlot < 0 || (size_t)bleSlot >= sensorSlots.size()) return;
+    snapshotDirty = true; // o snapshot sai no loopBLE(), uma vez por ciclo do agendador
+    BleSensorSlot& slot = sensorSlots[bleSlot];
+    if (!slot.pChar) return;
+
+    if (realTimeFormat == BLE_RT_FORMAT_BINARY) {
+        uint8_t packed[sizeof(float)];
+        memcpy(packed, &value, sizeof(packed)); // o ESP32 é little-endian
+        slot.pChar->setValue(packed, sizeof(packed));
+        slot.pChar->notify();
+        return;
+    }
 
-    // Procura a característica correta
-    auto it = characteristicMap.find(sensor_id);
-    if (it != characteristicMap.end()) {
-        BLECharacteristic* pCharacteristic = it->second;
-        pCharacteristic->setValue(jsonStr.c_str());
-        pCharacteristic->notify();
+    // Só o valor é escrito a cada notificação; NaN/infinito não são JSON válidos
+    char* out = slot.payload + slot.prefixLen;
+    size_t room = sizeof(slot.payload) - slot.prefixLen - slot.suffixLen;
+    int valueLen = isfinite(value) ? snprintf(out, room, "%.7g", (double)value) : snprintf(out, room, "null");
+    if (valueLen <= 0 || (size_t)valueLen >= room) return;
+    memcpy(out + valueLen, slot.suffix, slot.suffixLen);
 
-        Serial.printf("📤 Notificando sensor %s: %s\n", sensor_id.c_str(), jsonStr.c_str());
-    }
+    slot.pChar->setValue((uint8_t*)slot.payload, slot.prefixLen + valueLen + slot.suffixLen);
+    slot.pChar->notify();
 }
 
 void sendJsonInChunks(BLECharacteristic* pChar, const String& json) {
@@ -312,33 +820,96 @@ void sendJsonInChunks(BLECharacteristic* pChar, const String& json) {
     String jsonToSend = json;
     if (!jsonToSend.endsWith("\n")) jsonToSend += '\n';
 
-    const int chunkSize = 500; // Tamanho do fragmento (ajustar conforme teste)
-    int len = jsonToSend.length();
+    // Fragmentos do tamanho do MTU negociado; o notify() já espera pela pilha BLE entre envios
+    const size_t chunkSize = notifyPayloadSize();
+    const uint8_t* data = (const uint8_t*)jsonToSend.c_str();
+    size_t len = jsonToSend.length();
 
-    Serial.printf("📤 Enviando JSON em %d bytes, fragmentando em %d bytes...\n", len, chunkSize);
+    Serial.printf("📤 Enviando JSON em %u bytes, fragmentando em %u bytes...\n", (unsigned)len, (unsigned)chunkSize);
 
-    for (int i = 0; i < len; i += chunkSize) {
-        String part = jsonToSend.substring(i, min(i + chunkSize, len));
-        pChar->setValue(part.c_str());
+    for (size_t i = 0; i < len; i += chunkSize) {
+        pChar->setValue((uint8_t*)(data + i), min(chunkSize, len - i));
         pChar->notify();
-        delay(10); // Pequeno delay para o BLE não travar
     }
 
     Serial.println("✅ JSON enviado em fragments com sucesso.");
 }
 
 // --- loopBLE com a Nova Máquina de Estados ---
+/**
+ * @brief Notifica num só pacote o último valor de cada sensor (cabeçalho BleSnapshotHeader).
+ * Se não couber no MTU negociado, só atualiza o valor: o app lê-o como valor longo.
+ */
+static void sendSnapshot(DeviceController& meuDevice) {
+    snapshotDirty = false;
+    lastSnapshotMillis = millis();
+
+    BleSnapshotHeader header = { BLE_SNAPSHOT_VERSION, (uint8_t)sensorSlots.size(), snapshotConfigCrc,
+                                 (uint32_t)time(nullptr) };
+    memcpy(snapshotPayload.data(), &header, sizeof(header));
+    for (Sensor* s : meuDevice.getSensors()) {
+        if (!s || s->getBleSlot() < 0) continue;
+        float value = s->getLastValue();
+        memcpy(snapshotPayload.data() + sizeof(header) + s->getBleSlot() * sizeof(float), &value, sizeof(value));
+    }
+
+    pSnapshotCharacteristic->setValue(snapshotPayload.data(), snapshotPayload.size());
+    if (snapshotPayload.size() <= notifyPayloadSize()) pSnapshotCharacteristic->notify();
+}
+
 void loopBLE(DeviceController& meuDevice) {
   if (!deviceConnected) return;
 
-  if (syncRequested) {
-    realTimeStreamActive = false;
-    syncRequested = false;
-    configRequested = false;
-    handleSyncProcess();
-  } else if(configRequested){
+  // O sync corre na syncTask; aqui ficam os pedidos de tempo real, amostras recentes e configuração
+  if (notifyAllRequested) {
+    notifyAllRequested = false;
+    for (Sensor* s : meuDevice.getSensors()) {
+      if (s) s->notify();
+    }
+  }
+
+  // Um snapshot por ciclo: os sensores que notificaram no mesmo passo do agendador vão juntos
+  if (pSnapshotCharacteristic && snapshotDirty &&
+      millis() - lastSnapshotMillis >= HubConfig::getInstance().getBleSnapshot().intervalMs) {
+    sendSnapshot(meuDevice);
+  }
+
+  // Respostas no TX: com um sync em curso, os frames dele não podem ser intercalados com JSON;
+  // os pedidos ficam pendentes e saem no primeiro ciclo depois do EOT
+  if (!(recentRequested || rollupRequested || configRequested)) return;
+  if (!txMutex || xSemaphoreTake(txMutex, 0) != pdTRUE) return;
+
+  if (recentRequested) {
+    recentRequested = false;
+    const size_t sensorCount = meuDevice.getSensors().size();
+    DynamicJsonDocument recentDoc(JSON_OBJECT_SIZE(2) + JSON_ARRAY_SIZE(sensorCount) +
+                                  sensorCount * (JSON_OBJECT_SIZE(3) + JSON_ARRAY_SIZE(SENSOR_RING_CAPACITY) +
+                                                 SENSOR_RING_CAPACITY * JSON_ARRAY_SIZE(3)));
+    recentDoc["type"] = "recent";
+    JsonArray sensorsArray = recentDoc.createNestedArray("sensors");
+    meuDevice.recentSamplesToJson(sensorsArray, String(), recentLastN, recentSince);
+
+    String output;
+    serializeJson(recentDoc, output);
+    if (pTxCharacteristic) sendJsonInChunks(pTxCharacteristic, output);
+  }
+
+  if (rollupRequested) {
+    rollupRequested = false;
+    DynamicJsonDocument rollupDoc(JSON_OBJECT_SIZE(3) + meuDevice.rollupsJsonCapacity(BLE_ROLLUP_MAX_RECORDS));
+    rollupDoc["type"] = "rollups";
+    JsonArray sensorsArray = rollupDoc.createNestedArray("sensors");
+    time_t next = 0;
+    meuDevice.rollupsToJson(sensorsArray, String(), rollupWindow, rollupSince, 0, BLE_ROLLUP_MAX_RECORDS, next);
+    if (next != 0) rollupDoc["next"] = (uint32_t)next; // o app pede 0x11 + next para continuar
+
+    String output;
+    serializeJson(rollupDoc, output);
+    if (pTxCharacteristic) sendJsonInChunks(pTxCharacteristic, output);
+  }
+
+  if(configRequested){
     realTimeStreamActive = false;
-    syncRequested = false;
     configRequested = false;
         // Pega a string JSON da configuração do Hub (ex: {"hub_id": "...", ...})
     String configString = HubConfig::getInstance().getConfigJsonString();
@@ -346,7 +917,7 @@ void loopBLE(DeviceController& meuDevice) {
     // --- CORREÇÃO DA LÓGICA DE ANINHAMENTO ---
 
     // 1. Crie um documento temporário para analisar a 'configString'
-    StaticJsonDocument<512> dataDoc; // Escolha um tamanho adequado para a config do hub
+    DynamicJsonDocument dataDoc(1024); // o mesmo tamanho que o HubConfig usa para o ficheiro
     DeserializationError error = deserializeJson(dataDoc, configString);
 
     if (error) {
@@ -354,7 +925,7 @@ void loopBLE(DeviceController& meuDevice) {
         Serial.println(error.c_str());
     } else {
         // 2. Crie o documento principal que será enviado
-        StaticJsonDocument<2048> mainDoc; // Precisa ser grande o suficiente para conter o outro doc
+        DynamicJsonDocument mainDoc(3072); // Precisa ser grande o suficiente para conter o outro doc
         mainDoc["type"] = "config";
         
         // 3. Atribua o documento já analisado (dataDoc) ao campo "data". 
@@ -374,6 +945,14 @@ void loopBLE(DeviceController& meuDevice) {
             }
         }
 
+        // Os valores do snapshot seguem a ordem de "sensors"
+        if (pSnapshotCharacteristic) {
+            JsonObject snapshot = mainDoc.createNestedObject("snapshot");
+            snapshot["uuid"] = HUB_CHARACTERISTIC_SNAPSHOT;
+            snapshot["version"] = BLE_SNAPSHOT_VERSION;
+            snapshot["config_crc"] = snapshotConfigCrc;
+        }
+
 
         String output;
         serializeJson(mainDoc, output);
@@ -386,7 +965,6 @@ void loopBLE(DeviceController& meuDevice) {
 
     }
   }
-  
 
-  delay(10);
+  xSemaphoreGive(txMutex);
 }
@@ -7,7 +7,8 @@
 // As funções "públicas" do módulo não mudam
 void setupBLE(DeviceController& meuDevice);
 void loopBLE(DeviceController& meuDevice);
-void notifySensorValue(const String& sensor_id, float value);
+// bleSlot: índice atribuído ao sensor em setupBLE() (Sensor::getBleSlot())
+void notifySensorValue(int bleSlot, float value);
 void sendMainTxPacket(const String& jsonPacket);
 
 #endif
\ No newline at end of file
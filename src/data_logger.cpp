@@ -1,17 +1,162 @@
 #include "data_logger.h"
+#include "hub_config.h"
+#include "log_column.h"
+#include "sync_watermark.h"
 #include <ArduinoJson.h>
 #include <LittleFS.h>
 #include <sys/time.h>
 #include <vector>
-// --- VARIÁVEIS DE ESTADO PARA O STREAMING ---
-static std::vector<String> _streamFilePaths;
-static int _currentStreamFileIndex = -1;
-static File _currentStreamFile;
-static bool _isFirstChunk = true;
+#include <map>
+#include <freertos/semphr.h>
+#include <algorithm>
+#include <memory>
+// Cursor do stream global (prepareLogStream/readLogStreamChunk); o HTTP cria um por pedido
+static LogStreamCursor _logStream;
 
 const char* LOG_DIR = "/logs";
 #define LOG_LINES_PER_BLOCK 50
-File logFileBLE; // Handle de ficheiro para leitura sequencial do BLE
+LogFileReader logReaderBLE; // Leitor para leitura sequencial do BLE
+
+// Formato de gravação (lido do HubConfig em setupDataLogger)
+static LogFormat _logFormat = LogFormat::JSONL;
+// Ordem dos sensores no hub, usada como sensorIndex nos registos binários
+static std::vector<String> _logSensorIds;
+
+// --- WRITE-BEHIND: handles abertos e buffer em RAM por (dia, sensor) ---
+// Evita o ciclo exists/mkdir/open/write/close do LittleFS a cada amostra.
+#define LOG_MAX_OPEN_FILES 5          // handles mantidos abertos (um por sensor configurado)
+#define LOG_WRITE_BUFFER_SIZE 512     // bytes acumulados por ficheiro antes de gravar
+#define LOG_FLUSH_INTERVAL_MS 60000UL // tempo máximo de um registo parado no buffer
+
+struct LogWriteSlot {
+    String filePath;
+    File file;
+    uint8_t buffer[LOG_WRITE_BUFFER_SIZE];
+    size_t used;
+    unsigned long firstBufferedMillis;
+    unsigned long lastUseMillis;
+};
+
+static LogWriteSlot _writeSlots[LOG_MAX_OPEN_FILES];
+static int _currentDayKey = 0; // AAAAMMDD do diretório diário já garantido
+static SemaphoreHandle_t _logMutex = nullptr; // logger corre no loop, leitores na tarefa de sync BLE/AsyncTCP
+
+// Guarda de escopo para o mutex do logger (recursivo: flushLogs pode ser chamado com ele tomado)
+struct LogLock {
+    LogLock() { if (_logMutex) xSemaphoreTakeRecursive(_logMutex, portMAX_DELAY); }
+    ~LogLock() { if (_logMutex) xSemaphoreGiveRecursive(_logMutex); }
+};
+
+void lockLogs() {
+    if (_logMutex) xSemaphoreTakeRecursive(_logMutex, portMAX_DELAY);
+}
+
+void unlockLogs() {
+    if (_logMutex) xSemaphoreGiveRecursive(_logMutex);
+}
+
+// --- MANIFESTO DE CONTAGEM DE REGISTOS ---
+// Cada diretório diário guarda LOG_MANIFEST_NAME com {"<ficheiro>": {"n": registos, "b": bytes}}.
+// O total fica em RAM para o SOT; a varredura completa só é usada para reparar/verificar.
+#define LOG_MANIFEST_NAME "counts.json"
+
+#define LOG_MANIFEST_DOC_SIZE 2048
+
+struct LogFileCount {
+    uint32_t records;
+    uint32_t bytes;
+    uint32_t first; // epoch do primeiro e do último registo ("f" e "l" no manifesto)
+    uint32_t last;
+    uint32_t modified; // mtime do ficheiro ("m")
+};
+
+static uint32_t _totalRecords = 0;
+static String _dayCountsDir; // diretório do dia em escrita
+static bool _dayCountsDirty = false;
+
+// --- CATÁLOGO DOS FICHEIROS DE LOG ---
+// Espelho em RAM dos manifestos de todos os dias, ordenado por dia, sensor e formato.
+// Listagens, paginação e contagens por intervalo consultam-no em vez de percorrer /logs.
+static std::vector<LogCatalogEntry> _catalog;
+static std::vector<String> _catalogSensors; // ids referidos por LogCatalogEntry::sensor
+
+static bool _loadDayCounts(const String& dirPath, std::map<String, LogFileCount>& counts, bool forceRecount);
+static void _writeDayCounts(const String& dirPath, const std::map<String, LogFileCount>& counts);
+static uint32_t _loadAllCounts(bool forceRecount);
+
+// --- COMPACTAÇÃO DOS DIAS FECHADOS ---
+// Depois da virada de dia os ficheiros não voltam a ser escritos: o loopDataLogger comprime-os
+// para <ficheiro>.col (ou .gz) um pedaço de cada vez, sem atrasar a amostragem.
+#define LOG_COMPACT_CHECK_MS 60000UL // intervalo entre procuras de um ficheiro por comprimir
+#define LOG_COMPACT_STEP_BYTES 1024  // bytes do original processados por chamada de loopDataLogger
+
+struct LogCompaction {
+    LogCatalogEntry entry;
+    String srcPath;
+    String tmpPath;
+    LogCompression mode;
+    File dst;
+    // gzip: bytes do original, ~20 KB de compressor
+    File src;
+    std::unique_ptr<LogGzipWriter> gzip;
+    // colunar: registos do original como linhas JSON, ~3,5 KB de codificador
+    LogFileReader lines;
+    std::unique_ptr<LogColumnWriter> columns;
+    LogFileHeader header;  // metadados tirados da primeira linha
+    bool headerWritten;
+    uint32_t lineCrc;      // CRC-32 das linhas codificadas, conferido ao reler o .tmp
+    uint32_t outBytes;
+    bool written;          // .tmp completo e verificado, à espera de não haver leitores para a troca
+};
+
+enum CompactionResult : uint8_t { COMPACT_RUNNING, COMPACT_WAITING, COMPACT_DONE, COMPACT_SKIPPED };
+
+static LogCompression _compression = LogCompression::COLUMNAR;
+static LogCompaction* _compaction = nullptr;
+static unsigned long _lastCompactionCheck = 0;
+static std::vector<String> _compactionSkipped; // não encolheram ou falharam: só voltam a ser tentados após reiniciar
+
+static void _abortCompaction();
+static bool _reopenCompressedDay(uint32_t day);
+
+// --- RETENÇÃO ---
+// Política de "retention" do hub_config.json: apaga os dias mais antigos (idade, bytes, espaço livre)
+// e reduz os dias antigos a médias por intervalo. Corre no loopDataLogger, uma ação por chamada.
+#define LOG_RETENTION_CHECK_MS 60000UL  // intervalo entre verificações da política
+#define LOG_RETENTION_URGENT_MS 1000UL  // idem depois de uma escrita falhar por falta de espaço
+
+/**
+ * @brief Agregação de um ficheiro de um dia antigo: lê-o (comprimido ou não) um pedaço de cada vez
+ * e grava no mesmo formato um registo por intervalo, com a média de raw e value.
+ */
+struct LogDownsample {
+    LogCatalogEntry entry;
+    String srcPath;  // ficheiro atual (.col/.gz ou o original)
+    String outPath;  // resultado, sem compressão: a compactação volta a comprimi-lo
+    String tmpPath;
+    LogFileReader lines;
+    File dst;
+    LogFileHeader header; // metadados tirados da primeira linha
+    bool headerReady;
+    uint8_t sensorIndex;
+    uint32_t bucketStart;
+    uint32_t bucketCount;
+    int64_t rawSum;
+    double valueSum;
+    LogCatalogEntry out;  // registos, bytes e limites do resultado
+    bool written;         // .tmp completo, à espera de não haver leitores para a troca
+    uint32_t sourceRecords;            // registos do original já lidos
+    std::vector<uint32_t> sourceEnds;  // por registo gravado: registos do original até ao fim do seu intervalo
+};
+
+static LogRetentionPolicy _retention = { 0, 0, 0, 0, 3600 };
+static LogDownsample* _downsample = nullptr;
+static unsigned long _lastRetentionCheck = 0;
+static bool _retentionUrgent = false; // escrita falhou: liberta espaço antes de qualquer outra coisa
+static bool _retentionStuck = false;  // sem dias fechados para apagar (só avisa uma vez)
+static std::vector<String> _downsampleSkipped;
+
+static void _abortDownsample();
 
 // Inicializa LittleFS e cria diretório raiz
 void setupDataLogger() {
@@ -26,6 +171,457 @@ void setupDataLogger() {
             Serial.println("Diretório de logs principal '/logs' criado.");
         }
     }
+
+    if (!_logMutex) _logMutex = xSemaphoreCreateRecursiveMutex();
+
+    _logFormat = HubConfig::getInstance().getLogFormat();
+    Serial.printf("Formato de log: %s\n", _logFormat == LogFormat::BINARY ? "binário" : "JSONL");
+    _compression = HubConfig::getInstance().getLogCompression();
+    Serial.printf("Compactação dos dias fechados: %s\n", _compression == LogCompression::COLUMNAR ? "colunar" :
+                  _compression == LogCompression::GZIP ? "gzip" : "desativada");
+    _retention = HubConfig::getInstance().getLogRetention();
+    Serial.printf("Retenção: %u dias, %u bytes, %u bytes livres, médias de %us após %u dias (0 = sem limite)\n",
+                  (unsigned)_retention.maxDays, (unsigned)_retention.maxBytes, (unsigned)_retention.minFreeBytes,
+                  (unsigned)_retention.aggregateIntervalSec, (unsigned)_retention.aggregateAfterDays);
+
+    _totalRecords = _loadAllCounts(false);
+    Serial.printf("ℹ️ Manifesto de logs: %u registros.\n", (unsigned)_totalRecords);
+}
+
+void registerLogSensor(const String& sensorId) {
+    for (const String& id : _logSensorIds) {
+        if (id == sensorId) return;
+    }
+    _logSensorIds.push_back(sensorId);
+}
+
+static uint8_t _logSensorIndexOf(const String& sensorId) {
+    for (size_t i = 0; i < _logSensorIds.size(); i++) {
+        if (_logSensorIds[i] == sensorId) return (uint8_t)i;
+    }
+    return 0xFF; // sensor não registado
+}
+
+static bool _flushSlot(LogWriteSlot& slot) {
+    if (!slot.file || slot.used == 0) return true;
+
+    size_t written = slot.file.write(slot.buffer, slot.used);
+    slot.file.flush();
+    if (written == slot.used) {
+        slot.used = 0;
+        return true;
+    }
+
+    // Flash cheio: o que não foi gravado fica no buffer (continua o ficheiro) e a retenção liberta espaço já
+    Serial.printf("Falha ao gravar %u bytes em %s\n", (unsigned)(slot.used - written), slot.filePath.c_str());
+    memmove(slot.buffer, slot.buffer + written, slot.used - written);
+    slot.used -= written;
+    _retentionUrgent = true;
+    return false;
+}
+
+static void _closeSlot(LogWriteSlot& slot) {
+    _flushSlot(slot);
+    if (slot.file) slot.file.close();
+    slot.filePath = "";
+}
+
+static void _closeAllSlots() {
+    for (auto& slot : _writeSlots) _closeSlot(slot);
+}
+
+// Procura o handle já aberto do ficheiro; senão usa um livre ou fecha o menos usado
+static LogWriteSlot* _getWriteSlot(const String& filePath, bool& isNewFile) {
+    LogWriteSlot* freeSlot = nullptr;
+    LogWriteSlot* oldest = nullptr;
+    for (auto& slot : _writeSlots) {
+        if (slot.file && slot.filePath == filePath) {
+            isNewFile = false;
+            return &slot;
+        }
+        if (!slot.file) {
+            if (!freeSlot) freeSlot = &slot;
+        } else if (!oldest || slot.lastUseMillis < oldest->lastUseMillis) {
+            oldest = &slot;
+        }
+    }
+
+    LogWriteSlot* slot = freeSlot ? freeSlot : oldest;
+    if (slot->file) _closeSlot(*slot);
+
+    slot->file = LittleFS.open(filePath, FILE_APPEND);
+    if (!slot->file) {
+        Serial.printf("Falha ao abrir o arquivo de log: %s\n", filePath.c_str());
+        return nullptr;
+    }
+    slot->filePath = filePath;
+    slot->used = 0;
+    slot->lastUseMillis = millis();
+    isNewFile = (slot->file.size() == 0);
+    return slot;
+}
+
+static bool _bufferBytes(LogWriteSlot& slot, const uint8_t* data, size_t len) {
+    bool ok = true;
+    if (slot.used + len > LOG_WRITE_BUFFER_SIZE) ok = _flushSlot(slot);
+
+    if (len > LOG_WRITE_BUFFER_SIZE) {
+        return ok && slot.file.write(data, len) == len;
+    }
+    if (slot.used + len > LOG_WRITE_BUFFER_SIZE) return false; // nem gravou nem há espaço no buffer
+
+    if (slot.used == 0) slot.firstBufferedMillis = millis();
+    memcpy(slot.buffer + slot.used, data, len);
+    slot.used += len;
+    slot.lastUseMillis = millis();
+    return true; // o que não coube no flash continua no buffer
+}
+
+static String _fileBaseName(const String& path) {
+    int lastSlash = path.lastIndexOf('/');
+    return (lastSlash != -1) ? path.substring(lastSlash + 1) : path;
+}
+
+// Conta os registos de um ficheiro lendo-o por inteiro (.bin não comprimido: pelo tamanho; .col: pelos blocos)
+static uint32_t _countRecordsInFile(const String& filePath) {
+    if (filePath.endsWith(LOG_COL_EXT)) {
+        std::unique_ptr<LogColumnReader> reader(new LogColumnReader());
+        return reader->open(filePath) ? reader->recordCount() : 0;
+    }
+    if (filePath.endsWith(LOG_BIN_EXT)) {
+        File f = LittleFS.open(filePath, "r");
+        if (!f) return 0;
+        size_t size = f.size();
+        f.close();
+        return size > sizeof(LogFileHeader) ? (size - sizeof(LogFileHeader)) / sizeof(LogRecord) : 0;
+    }
+
+    uint32_t count = 0;
+    LogFileReader reader;
+    if (!reader.open(filePath)) return 0;
+    char line[LOG_LINE_MAX];
+    while (reader.readNextLine(line, sizeof(line)) > 0) count++;
+    reader.close();
+    return count;
+}
+
+// Timestamps do primeiro e do último registo: lê só o início e o fim do ficheiro
+// (.gz: o seek até ao fim descomprime o ficheiro todo, mas só acontece ao reparar manifestos)
+static void _readFileTimeBounds(const String& filePath, uint32_t& first, uint32_t& last) {
+    first = 0;
+    last = 0;
+
+    if (filePath.endsWith(LOG_COL_EXT)) {
+        std::unique_ptr<LogColumnReader> reader(new LogColumnReader());
+        if (reader->open(filePath)) reader->timeBounds(first, last); // só os cabeçalhos dos blocos
+        return;
+    }
+
+    if (filePath.endsWith(LOG_BIN_EXT)) {
+        File f = LittleFS.open(filePath, "r");
+        if (!f) return;
+        LogFileHeader header;
+        size_t records = f.size() > sizeof(header) ? (f.size() - sizeof(header)) / sizeof(LogRecord) : 0;
+        if (records == 0 || f.read((uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+            f.close();
+            return;
+        }
+        LogRecord record;
+        for (size_t i = 0; i < records && first == 0; i++) {
+            if (f.read((uint8_t*)&record, sizeof(record)) == sizeof(record) && isValidLogRecord(record)) first = record.timestamp;
+        }
+        for (size_t i = records; i > 0 && last == 0; i--) {
+            f.seek(sizeof(header) + (i - 1) * sizeof(LogRecord));
+            if (f.read((uint8_t*)&record, sizeof(record)) == sizeof(record) && isValidLogRecord(record)) last = record.timestamp;
+        }
+        f.close();
+        return;
+    }
+
+    LogFileReader reader;
+    if (!reader.open(filePath)) return;
+    char line[LOG_LINE_MAX];
+    if (reader.readNextLine(line, sizeof(line)) > 0) first = parseLogTimestamp(line);
+
+    // Só as últimas linhas: a primeira lida depois do seek pode vir cortada e é descartada
+    size_t tail = 2 * LOG_LINE_MAX;
+    if (reader.size() > reader.position() + tail) {
+        reader.seek(reader.size() - tail);
+        reader.readNextLine(line, sizeof(line));
+    }
+    last = first;
+    while (reader.readNextLine(line, sizeof(line)) > 0) {
+        time_t ts = parseLogTimestamp(line);
+        if (ts != 0) last = ts;
+    }
+    reader.close();
+}
+
+static uint32_t _dayKeyOf(const String& dayDirName) {
+    int year, month, day;
+    if (sscanf(dayDirName.c_str(), "%d_%d_%d", &year, &month, &day) != 3) return 0;
+    return year * 10000 + month * 100 + day;
+}
+
+static String _dayDirPath(uint32_t day) {
+    char dirPath[32];
+    snprintf(dirPath, sizeof(dirPath), "%s/%04u_%02u_%02u", LOG_DIR,
+             (unsigned)(day / 10000), (unsigned)(day / 100 % 100), (unsigned)(day % 100));
+    return String(dirPath);
+}
+
+static uint16_t _catalogSensorSlot(const String& sensorId) {
+    for (size_t i = 0; i < _catalogSensors.size(); i++) {
+        if (_catalogSensors[i] == sensorId) return (uint16_t)i;
+    }
+    _catalogSensors.push_back(sensorId);
+    return (uint16_t)(_catalogSensors.size() - 1);
+}
+
+// Mesma ordem dos caminhos: dia, nome do sensor e ".bin" antes de ".jsonl".
+// Comprimido ou não é o mesmo item: a compactação só troca o ficheiro por baixo.
+static bool _catalogLess(const LogCatalogEntry& a, const LogCatalogEntry& b) {
+    if (a.day != b.day) return a.day < b.day;
+    if (a.sensor != b.sensor) return _catalogSensors[a.sensor] < _catalogSensors[b.sensor];
+    return a.binary && !b.binary;
+}
+
+// Item do ficheiro (dia, sensor, formato), criado vazio se ainda não existir
+static LogCatalogEntry& _catalogEntryFor(uint32_t day, const String& sensorId, bool binary) {
+    LogCatalogEntry key = {};
+    key.day = day;
+    key.sensor = _catalogSensorSlot(sensorId);
+    key.binary = binary;
+
+    auto it = std::lower_bound(_catalog.begin(), _catalog.end(), key, _catalogLess);
+    if (it == _catalog.end() || _catalogLess(key, *it)) it = _catalog.insert(it, key);
+    return *it;
+}
+
+// Substitui os itens de um dia pelos do manifesto (carga inicial, virada de dia, reparo)
+static void _catalogSetDay(uint32_t day, const std::map<String, LogFileCount>& counts) {
+    _catalog.erase(std::remove_if(_catalog.begin(), _catalog.end(),
+                                  [day](const LogCatalogEntry& entry) { return entry.day == day; }),
+                   _catalog.end());
+    for (const auto& kv : counts) {
+        String name = logUncompressedName(kv.first);
+        LogCatalogEntry& entry = _catalogEntryFor(day, name.substring(0, name.lastIndexOf('.')), name.endsWith(LOG_BIN_EXT));
+        entry.compression = logCompressionOf(kv.first);
+        entry.bytes = kv.second.bytes;
+        entry.records = kv.second.records;
+        entry.firstTs = kv.second.first;
+        entry.lastTs = kv.second.last;
+        entry.modified = kv.second.modified;
+    }
+}
+
+// Manifesto de um dia montado a partir do catálogo
+static std::map<String, LogFileCount> _catalogDayCounts(uint32_t day) {
+    std::map<String, LogFileCount> counts;
+    for (const LogCatalogEntry& entry : _catalog) {
+        if (entry.day != day) continue;
+        counts[logCatalogFileName(entry)] = { entry.records, entry.bytes, entry.firstTs, entry.lastTs, entry.modified };
+    }
+    return counts;
+}
+
+static bool _catalogInRange(const LogCatalogEntry& entry, time_t since, time_t until) {
+    if (since == 0 && until == 0) return true;
+    if (entry.records == 0) return false;
+    if (since != 0 && (time_t)entry.lastTs < since) return false;
+    if (until != 0 && (time_t)entry.firstTs > until) return false;
+    return true;
+}
+
+size_t getLogCatalogSize() {
+    LogLock lock;
+    return _catalog.size();
+}
+
+bool getLogCatalogEntry(size_t index, LogCatalogEntry& entry) {
+    LogLock lock;
+    if (index >= _catalog.size()) return false;
+    entry = _catalog[index];
+    return true;
+}
+
+std::vector<LogCatalogEntry> findLogCatalogEntries(const String& sensorId, time_t since, time_t until) {
+    LogLock lock;
+    std::vector<LogCatalogEntry> entries;
+    for (const LogCatalogEntry& entry : _catalog) {
+        if (sensorId.length() > 0 && _catalogSensors[entry.sensor] != sensorId) continue;
+        if (_catalogInRange(entry, since, until)) entries.push_back(entry);
+    }
+    return entries;
+}
+
+String logCatalogSensorId(const LogCatalogEntry& entry) {
+    LogLock lock;
+    return entry.sensor < _catalogSensors.size() ? _catalogSensors[entry.sensor] : String();
+}
+
+String logCatalogFileName(const LogCatalogEntry& entry) {
+    return logCatalogSensorId(entry) + (entry.binary ? LOG_BIN_EXT : LOG_JSONL_EXT) + logCompressionExt(entry.compression);
+}
+
+String logCatalogPath(const LogCatalogEntry& entry) {
+    return _dayDirPath(entry.day) + "/" + logCatalogFileName(entry);
+}
+
+// Lê o manifesto do dia e confere-o com os ficheiros presentes; só reconta os que divergirem
+static bool _loadDayCounts(const String& dirPath, std::map<String, LogFileCount>& counts, bool forceRecount) {
+    std::map<String, LogFileCount> stored;
+    if (!forceRecount) {
+        File mf = LittleFS.open(dirPath + "/" + LOG_MANIFEST_NAME, "r");
+        if (mf) {
+            DynamicJsonDocument doc(LOG_MANIFEST_DOC_SIZE);
+            if (!deserializeJson(doc, mf)) {
+                for (JsonPair kv : doc.as<JsonObject>()) {
+                    stored[String(kv.key().c_str())] = { kv.value()["n"] | 0u, kv.value()["b"] | 0u,
+                                                         kv.value()["f"] | 0u, kv.value()["l"] | 0u,
+                                                         kv.value()["m"] | 0u };
+                }
+            }
+            mf.close();
+        }
+    }
+
+    bool repaired = false;
+    counts.clear();
+    File dir = LittleFS.open(dirPath);
+    if (!dir || !dir.isDirectory()) return false;
+
+    std::vector<String> superseded;
+    File f = dir.openNextFile();
+    while (f) {
+        String name = _fileBaseName(String(f.name()));
+        if (!f.isDirectory() && !isCompressedLogFileName(name) && isLogFileName(name) &&
+            (LittleFS.exists(dirPath + "/" + name + LOG_GZIP_EXT) || LittleFS.exists(dirPath + "/" + name + LOG_COL_EXT))) {
+            // O .gz/.col só aparece depois de verificado: o original ficou de uma compactação interrompida
+            superseded.push_back(name);
+        } else if (!f.isDirectory() && isLogFileName(name)) {
+            auto it = stored.find(name);
+            if (it != stored.end() && it->second.bytes == f.size()) {
+                LogFileCount count = it->second;
+                if (count.modified == 0) {
+                    // Manifesto sem "m": o mtime vem do ficheiro já aberto pela listagem
+                    count.modified = (uint32_t)f.getLastWrite();
+                    repaired = true;
+                }
+                if (count.records > 0 && count.first == 0) {
+                    // Manifesto anterior ao catálogo: só faltam os timestamps
+                    f.close();
+                    _readFileTimeBounds(dirPath + "/" + name, count.first, count.last);
+                    repaired = true;
+                }
+                counts[name] = count;
+            } else {
+                LogFileCount count = { 0, (uint32_t)f.size(), 0, 0, (uint32_t)f.getLastWrite() };
+                f.close();
+                count.records = _countRecordsInFile(dirPath + "/" + name);
+                _readFileTimeBounds(dirPath + "/" + name, count.first, count.last);
+                counts[name] = count;
+                repaired = true;
+            }
+        }
+        f.close();
+        f = dir.openNextFile();
+    }
+    dir.close();
+
+    for (const String& name : superseded) {
+        LittleFS.remove(dirPath + "/" + name);
+        LittleFS.remove(logIndexPathFor(dirPath + "/" + name));
+    }
+
+    // Entradas de ficheiros que já não existem também obrigam a regravar
+    if (counts.size() != stored.size()) repaired = true;
+    return repaired;
+}
+
+static void _writeDayCounts(const String& dirPath, const std::map<String, LogFileCount>& counts) {
+    DynamicJsonDocument doc(LOG_MANIFEST_DOC_SIZE);
+    for (const auto& entry : counts) {
+        JsonObject obj = doc.createNestedObject(entry.first);
+        obj["n"] = entry.second.records;
+        obj["b"] = entry.second.bytes;
+        obj["f"] = entry.second.first;
+        obj["l"] = entry.second.last;
+        obj["m"] = entry.second.modified;
+    }
+
+    // Grava num temporário e renomeia, para nunca deixar um manifesto truncado
+    String tmpPath = dirPath + "/" + LOG_MANIFEST_NAME + ".tmp";
+    File mf = LittleFS.open(tmpPath, "w");
+    if (!mf) {
+        Serial.printf("Falha ao gravar manifesto em %s\n", dirPath.c_str());
+        return;
+    }
+    serializeJson(doc, mf);
+    mf.close();
+    LittleFS.rename(tmpPath, dirPath + "/" + LOG_MANIFEST_NAME);
+}
+
+static void _saveDayCounts() {
+    if (!_dayCountsDirty || _dayCountsDir.length() == 0) return;
+    _writeDayCounts(_dayCountsDir, _catalogDayCounts(_currentDayKey));
+    _dayCountsDirty = false;
+}
+
+// Percorre os diretórios diários, regravando os manifestos que precisaram de reparo,
+// e monta o catálogo com o que encontrar
+static uint32_t _loadAllCounts(bool forceRecount) {
+    uint32_t total = 0;
+    _catalog.clear();
+    _catalogSensors.clear();
+    File root = LittleFS.open(LOG_DIR);
+    if (!root || !root.isDirectory()) return 0;
+
+    File dir = root.openNextFile();
+    while (dir) {
+        String dayName = _fileBaseName(String(dir.name()));
+        if (dir.isDirectory() && _dayKeyOf(dayName) != 0) {
+            String dirPath = String(LOG_DIR) + "/" + dayName;
+            std::map<String, LogFileCount> counts;
+            if (_loadDayCounts(dirPath, counts, forceRecount)) {
+                Serial.printf("🔧 Manifesto reparado: %s\n", dirPath.c_str());
+                _writeDayCounts(dirPath, counts);
+            }
+            _catalogSetDay(_dayKeyOf(dayName), counts);
+            for (const auto& entry : counts) total += entry.second.records;
+        }
+        dir.close();
+        dir = root.openNextFile();
+    }
+    root.close();
+    return total;
+}
+
+// Atualiza o item do catálogo; recordTs 0 = bytes que não são registo (cabeçalho .bin)
+static void _countAppended(LogCatalogEntry& count, size_t bytes, time_t recordTs) {
+    count.bytes += bytes;
+    count.modified = (uint32_t)time(nullptr); // o write-behind grava no flash até LOG_FLUSH_INTERVAL_MS depois
+    if (recordTs != 0) {
+        if (count.records == 0) count.firstTs = (uint32_t)recordTs;
+        count.lastTs = (uint32_t)recordTs;
+        count.records++;
+        _totalRecords++;
+    }
+    _dayCountsDirty = true;
+}
+
+// A cada LOG_INDEX_INTERVAL registos acrescenta (timestamp, offset) ao índice .idx do ficheiro
+static void _indexRecord(const String& filePath, const LogCatalogEntry& count, time_t now) {
+    if (count.records % LOG_INDEX_INTERVAL != 0) return;
+
+    LogIndexEntry entry;
+    entry.timestamp = (uint32_t)now;
+    entry.offset = count.bytes; // bytes já escritos (ou em buffer) = início deste registo
+
+    File idx = LittleFS.open(logIndexPathFor(filePath), FILE_APPEND);
+    if (!idx) return;
+    idx.write((const uint8_t*)&entry, sizeof(entry));
+    idx.close();
 }
 
 // Salva leitura de sensor em subpasta diária
@@ -43,26 +639,54 @@ void logSensorReading(time_t now, const String& sensorId, const String& sensorTy
     // Cria caminho do diretório diário
     char dirPath[32];
     sprintf(dirPath, "%s/%d_%02d_%02d", LOG_DIR, timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday);
+    int dayKey = (timeinfo.tm_year + 1900) * 10000 + (timeinfo.tm_mon + 1) * 100 + timeinfo.tm_mday;
 
-    if (LittleFS.exists(dirPath)){
-      //Serial.printf("JA EXISTE: %s\n", dirPath);
-    }
-    // Cria diretório diário se não existir
-    if (!LittleFS.exists(dirPath)) {
-        if (LittleFS.mkdir(dirPath)) {
-           // Serial.printf("Novo diretório diário criado: %s\n", dirPath);
-        } else {
-           // Serial.printf("Falha ao criar diretório diário: %s\n", dirPath);
+    LogLock lock;
+
+    // Virada de dia: grava e fecha os ficheiros do dia anterior e garante o novo diretório
+    if (dayKey != _currentDayKey) {
+        _closeAllSlots();
+        _saveDayCounts();
+        if (!LittleFS.exists(dirPath) && !LittleFS.mkdir(dirPath)) {
+            Serial.printf("Falha ao criar diretório diário: %s\n", dirPath);
             return;
         }
+        _currentDayKey = dayKey;
+        _dayCountsDir = dirPath;
+        std::map<String, LogFileCount> counts;
+        _dayCountsDirty = _loadDayCounts(_dayCountsDir, counts, false);
+        _catalogSetDay(dayKey, counts);
+        if (_reopenCompressedDay(dayKey)) _dayCountsDirty = true;
     }
 
-    // Caminho completo do arquivo do sensor
-    String filePath = String(dirPath) + "/" + sensorId + ".jsonl";
+    bool binary = (_logFormat == LogFormat::BINARY);
+    String filePath = String(dirPath) + "/" + sensorId + (binary ? LOG_BIN_EXT : LOG_JSONL_EXT);
 
-    File file = LittleFS.open(filePath, FILE_APPEND);
-    if (!file) {
-        Serial.printf("Falha ao abrir o arquivo de log: %s\n", filePath.c_str());
+    bool isNewFile = false;
+    LogWriteSlot* slot = _getWriteSlot(filePath, isNewFile);
+    if (!slot) return;
+    LogCatalogEntry& count = _catalogEntryFor(dayKey, sensorId, binary);
+
+    if (binary) {
+        // O cabeçalho é gravado apenas quando o ficheiro ainda está vazio
+        if (isNewFile) {
+            LogFileHeader header;
+            initLogFileHeader(header, sensorId, sensorType, unit);
+            if (!_bufferBytes(*slot, (const uint8_t*)&header, sizeof(header))) {
+                Serial.println("Falha ao escrever cabeçalho binário no arquivo.");
+                return;
+            }
+            _countAppended(count, sizeof(header), 0);
+        }
+
+        LogRecord record;
+        encodeLogRecord(record, now, _logSensorIndexOf(sensorId), rawValue, calibratedValue);
+        if (!_bufferBytes(*slot, (const uint8_t*)&record, sizeof(record))) {
+            Serial.println("Falha ao escrever registo binário no arquivo.");
+            return; // não contado: o manifesto continua a bater com o ficheiro
+        }
+        _indexRecord(filePath, count, now);
+        _countAppended(count, sizeof(record), now);
         return;
     }
 
@@ -78,14 +702,718 @@ void logSensorReading(time_t now, const String& sensorId, const String& sensorTy
     doc["value"] = serialized(String(calibratedValue, 2));
     doc["unit"] = unit;
 
-    if (serializeJson(doc, file)) {
-        file.println();
-        //Serial.printf("Registro salvo para '%s'\n", sensorId.c_str());
-    } else {
+    char line[LOG_LINE_MAX];
+    size_t len = serializeJson(doc, line, sizeof(line) - 2);
+    if (len == 0 || len >= sizeof(line) - 2) {
+        Serial.println("Falha ao escrever JSON no arquivo.");
+        return;
+    }
+    line[len++] = '\r'; // mesmo terminador do antigo file.println()
+    line[len++] = '\n';
+
+    if (!_bufferBytes(*slot, (const uint8_t*)line, len)) {
         Serial.println("Falha ao escrever JSON no arquivo.");
+        return; // não contado: o manifesto continua a bater com o ficheiro
+    }
+    _indexRecord(filePath, count, now);
+    _countAppended(count, len, now);
+}
+
+void flushLogs() {
+    LogLock lock;
+    for (auto& slot : _writeSlots) _flushSlot(slot);
+    _saveDayCounts();
+}
+
+// Dia de hoje (AAAAMMDD): o último em que o logger escreveu ou, antes disso, o do relógio
+static uint32_t _todayKey() {
+    if (_currentDayKey != 0) return _currentDayKey;
+    time_t now = time(nullptr);
+    if (now < 1704067200) return 0; // relógio por acertar: não há como saber que dias estão fechados
+    struct tm timeinfo;
+    localtime_r(&now, &timeinfo);
+    return (timeinfo.tm_year + 1900) * 10000 + (timeinfo.tm_mon + 1) * 100 + timeinfo.tm_mday;
+}
+
+static void _closeCompaction(LogCompaction& job) {
+    job.src.close();
+    job.dst.close();
+    job.lines.close();
+    LittleFS.remove(job.tmpPath);
+}
+
+static void _abortCompaction() {
+    if (!_compaction) return;
+    _closeCompaction(*_compaction);
+    delete _compaction;
+    _compaction = nullptr;
+}
+
+// Abre o original e o .tmp no modo pedido (o cabeçalho .col só é gravado com a primeira linha)
+static bool _openCompaction(LogCompaction& job, LogCompression mode) {
+    job.mode = mode;
+    job.tmpPath = job.srcPath + logCompressionExt(mode) + ".tmp";
+    job.headerWritten = false;
+    job.lineCrc = 0;
+    job.outBytes = 0;
+    job.written = false;
+    job.dst = LittleFS.open(job.tmpPath, "w");
+    if (!job.dst) return false;
+
+    if (mode == LogCompression::COLUMNAR) {
+        job.columns.reset(new LogColumnWriter());
+        return job.lines.open(job.srcPath);
+    }
+    job.gzip.reset(new LogGzipWriter());
+    job.src = LittleFS.open(job.srcPath, "r");
+    return job.src && job.gzip->begin(job.dst, job.entry.lastTs);
+}
+
+// Escolhe o ficheiro mais antigo ainda não comprimido de um dia fechado
+static bool _startCompaction() {
+    uint32_t today = _todayKey();
+    if (today == 0) return false;
+
+    for (const LogCatalogEntry& entry : _catalog) {
+        if (entry.day >= today) break; // catálogo ordenado por dia
+        if (entry.compression != LogCompression::NONE || entry.records == 0) continue;
+        String path = logCatalogPath(entry);
+        if (std::find(_compactionSkipped.begin(), _compactionSkipped.end(), path) != _compactionSkipped.end()) continue;
+
+        _compaction = new LogCompaction();
+        _compaction->entry = entry;
+        _compaction->srcPath = path;
+        if (_openCompaction(*_compaction, _compression)) return true;
+        Serial.printf("⚠️ Compactação: falha ao abrir %s\n", path.c_str());
+        _compactionSkipped.push_back(path);
+        _abortCompaction();
     }
+    return false;
+}
 
-    file.close();
+// Registo de uma linha JSON; com 'header' também devolve os metadados do sensor
+static bool _parseLogLine(const char* line, LogRecord& record, LogFileHeader* header) {
+    StaticJsonDocument<384> doc;
+    if (deserializeJson(doc, line)) return false;
+    if (header) initLogFileHeader(*header, doc["sensorId"] | "", doc["sensorType"] | "", doc["unit"] | "");
+    encodeLogRecord(record, parseLogTimestamp(line), 0, doc["raw"] | 0, doc["value"] | 0.0f);
+    return true;
+}
+
+// Registo de uma linha do original; a primeira também dá os metadados do cabeçalho .col
+static bool _parseColumnLine(LogCompaction& job, const char* line, LogRecord& record) {
+    if (!_parseLogLine(line, record, job.headerWritten ? nullptr : &job.header)) return false;
+    if (!job.headerWritten) {
+        if (!job.columns->begin(job.dst, job.header)) return false;
+        job.headerWritten = true;
+    }
+    return true;
+}
+
+// Codifica um pedaço em colunas. Só aceita linhas que o .col devolve iguais (campos, ordem, 2 casas
+// decimais); uma linha diferente (firmware antigo, campo extra) faz o ficheiro todo ir para gzip.
+static bool _compactColumnsChunk(LogCompaction& job, bool& more) {
+    char line[LOG_LINE_MAX];
+    char check[LOG_LINE_MAX];
+    size_t done = 0;
+    size_t len = 0;
+    while (done < LOG_COMPACT_STEP_BYTES && (len = job.lines.readNextLine(line, sizeof(line))) > 0) {
+        LogRecord record;
+        if (!_parseColumnLine(job, line, record) ||
+            formatLogRecordJson(job.header, record, check, sizeof(check)) != len || memcmp(check, line, len) != 0 ||
+            !job.columns->add(record.timestamp, record.raw, record.value)) {
+            return false;
+        }
+        job.lineCrc = logCrc32(job.lineCrc, (const uint8_t*)line, len);
+        done += len;
+    }
+    more = len > 0;
+    return true;
+}
+
+// Relê o .tmp e confere tamanho e CRC-32 com o que foi comprimido
+static bool _verifyGzip(LogCompaction& job) {
+    std::unique_ptr<LogGzipReader> reader(new LogGzipReader()); // janela de 4 KB: fora da pilha do loop
+    if (!reader->open(job.tmpPath) || reader->size() != job.gzip->inputSize()) return false;
+    job.outBytes = reader->compressedSize();
+
+    uint8_t buf[128];
+    uint32_t crc = 0;
+    size_t total = 0;
+    size_t n;
+    while ((n = reader->read(buf, sizeof(buf))) > 0) {
+        crc = logCrc32(crc, buf, n);
+        total += n;
+    }
+    return total == job.gzip->inputSize() && crc == job.gzip->crc();
+}
+
+// Relê o .tmp e confere que decodifica para as mesmas linhas (contagem e CRC-32)
+static bool _verifyColumns(LogCompaction& job) {
+    std::unique_ptr<LogColumnReader> reader(new LogColumnReader());
+    if (!job.headerWritten || !reader->open(job.tmpPath)) return false;
+    job.outBytes = reader->fileSize();
+
+    char line[LOG_LINE_MAX];
+    LogRecord record;
+    uint32_t crc = 0;
+    uint32_t records = 0;
+    while (reader->next(record)) {
+        size_t len = formatLogRecordJson(reader->header(), record, line, sizeof(line));
+        crc = logCrc32(crc, (const uint8_t*)line, len);
+        records++;
+    }
+    return records == job.columns->recordCount() && crc == job.lineCrc;
+}
+
+// Um passo da compactação em curso: comprime um pedaço, fecha e verifica, ou troca os ficheiros
+static CompactionResult _compactionStep() {
+    LogCompaction& job = *_compaction;
+    if (!job.written) {
+        bool ok;
+        if (job.mode == LogCompression::COLUMNAR) {
+            bool more = false;
+            if (!_compactColumnsChunk(job, more)) {
+                Serial.printf("ℹ️ %s tem linhas fora do formato colunar; comprime em gzip.\n", job.srcPath.c_str());
+                _closeCompaction(job);
+                job.columns.reset();
+                if (!_openCompaction(job, LogCompression::GZIP)) {
+                    _compactionSkipped.push_back(job.srcPath);
+                    _abortCompaction();
+                    return COMPACT_SKIPPED;
+                }
+                return COMPACT_RUNNING;
+            }
+            if (more) return COMPACT_RUNNING;
+
+            ok = job.columns->finish();
+            job.lines.close();
+            job.dst.close();
+            ok = ok && _verifyColumns(job);
+        } else {
+            uint8_t buf[256];
+            size_t done = 0;
+            size_t n = 0;
+            while (done < LOG_COMPACT_STEP_BYTES && (n = job.src.read(buf, sizeof(buf))) > 0) {
+                job.gzip->write(buf, n);
+                done += n;
+            }
+            if (n > 0) return COMPACT_RUNNING;
+
+            ok = job.gzip->finish();
+            job.dst.close();
+            job.src.close();
+            ok = ok && _verifyGzip(job);
+        }
+        if (!ok || job.outBytes >= job.entry.bytes) {
+            Serial.printf("⚠️ Compactação de %s %s; fica como está.\n", job.srcPath.c_str(),
+                          ok ? "não reduz o tamanho" : "falhou a verificação");
+            _compactionSkipped.push_back(job.srcPath);
+            _abortCompaction();
+            return COMPACT_SKIPPED;
+        }
+        job.written = true;
+    }
+
+    // Um leitor a meio do original (sync BLE, download) não pode perdê-lo: espera que fechem
+    if (logFilesInUse() > 0) return COMPACT_WAITING;
+
+    String outPath = job.srcPath + logCompressionExt(job.mode);
+    if (!LittleFS.rename(job.tmpPath, outPath)) {
+        Serial.printf("⚠️ Compactação: falha ao renomear %s\n", job.tmpPath.c_str());
+        _compactionSkipped.push_back(job.srcPath);
+        _abortCompaction();
+        return COMPACT_SKIPPED;
+    }
+    // Se a remoção falhar, o comprimido já manda e o original é apagado no próximo arranque
+    if (!LittleFS.remove(job.srcPath)) {
+        Serial.printf("⚠️ Compactação: %s fica até ao próximo arranque\n", job.srcPath.c_str());
+    }
+    LittleFS.remove(logIndexPathFor(job.srcPath)); // .gz é lido desde o início; .col tem os limites por bloco
+
+    LogCatalogEntry& entry = _catalogEntryFor(job.entry.day, _catalogSensors[job.entry.sensor], job.entry.binary);
+    entry.compression = job.mode;
+    entry.bytes = job.outBytes;
+    entry.modified = (uint32_t)time(nullptr);
+    _writeDayCounts(job.srcPath.substring(0, job.srcPath.lastIndexOf('/')), _catalogDayCounts(job.entry.day));
+
+    Serial.printf("🗜️ Compactado %s (%s): %u -> %u bytes\n", job.srcPath.c_str(),
+                  job.mode == LogCompression::COLUMNAR ? "colunar" : "gzip",
+                  (unsigned)job.entry.bytes, (unsigned)job.outBytes);
+    delete _compaction;
+    _compaction = nullptr;
+    return COMPACT_DONE;
+}
+
+// Descomprime um .gz para 'out'; devolve o número de bytes gravados (0 em caso de falha)
+static size_t _inflateTo(const String& gzPath, File& out) {
+    std::unique_ptr<LogGzipReader> reader(new LogGzipReader());
+    if (!reader->open(gzPath)) return 0;
+
+    uint8_t buf[256];
+    size_t total = 0;
+    size_t n;
+    while ((n = reader->read(buf, sizeof(buf))) > 0) {
+        if (out.write(buf, n) != n) return 0;
+        total += n;
+    }
+    return total == reader->size() ? total : 0;
+}
+
+// Grava um registo no formato do ficheiro (linha JSONL ou registo .bin); devolve os bytes gravados (0 = falha)
+static size_t _writeLogRecord(File& out, bool binary, const LogFileHeader& header, uint8_t sensorIndex, const LogRecord& record) {
+    if (binary) {
+        LogRecord binRecord;
+        encodeLogRecord(binRecord, record.timestamp, sensorIndex, record.raw, record.value);
+        return out.write((const uint8_t*)&binRecord, sizeof(binRecord)) == sizeof(binRecord) ? sizeof(binRecord) : 0;
+    }
+    char line[LOG_LINE_MAX + 2];
+    size_t len = formatLogRecordJson(header, record, line, LOG_LINE_MAX);
+    line[len++] = '\r'; // mesmo terminador do logSensorReading
+    line[len++] = '\n';
+    return out.write((const uint8_t*)line, len) == len ? len : 0;
+}
+
+// Decodifica um .col de volta ao formato original: linhas JSONL ou cabeçalho e registos .bin
+static size_t _decodeColumnsTo(const String& colPath, File& out, bool binary) {
+    std::unique_ptr<LogColumnReader> reader(new LogColumnReader());
+    if (!reader->open(colPath)) return 0;
+
+    const LogFileHeader& colHeader = reader->header();
+    size_t total = 0;
+    if (binary) {
+        // Mesmos metadados, com o magic e a versão do .bin
+        LogFileHeader header = colHeader;
+        memcpy(header.magic, LOG_BIN_MAGIC, sizeof(header.magic));
+        header.version = LOG_BIN_VERSION;
+        header.recordSize = sizeof(LogRecord);
+        if (out.write((const uint8_t*)&header, sizeof(header)) != sizeof(header)) return 0;
+        total += sizeof(header);
+    }
+
+    char sensorId[sizeof(colHeader.sensorId) + 1] = {};
+    memcpy(sensorId, colHeader.sensorId, sizeof(colHeader.sensorId));
+    uint8_t sensorIndex = _logSensorIndexOf(String(sensorId));
+    LogRecord record;
+    while (reader->next(record)) {
+        size_t len = _writeLogRecord(out, binary, colHeader, sensorIndex, record);
+        if (len == 0) return 0;
+        total += len;
+    }
+    return total;
+}
+
+// O relógio voltou a um dia já compactado: descomprime os ficheiros dele antes de voltar a escrever
+static bool _reopenCompressedDay(uint32_t day) {
+    if (_compaction && _compaction->entry.day == day) _abortCompaction();
+    if (_downsample && _downsample->entry.day == day) _abortDownsample();
+
+    bool reopened = false;
+    for (LogCatalogEntry& entry : _catalog) {
+        if (entry.day != day || entry.compression == LogCompression::NONE) continue;
+
+        String compressedPath = logCatalogPath(entry);
+        String path = logUncompressedName(compressedPath);
+        File out = LittleFS.open(path + ".tmp", "w");
+        size_t total = 0;
+        if (out) {
+            total = entry.compression == LogCompression::COLUMNAR ? _decodeColumnsTo(compressedPath, out, entry.binary)
+                                                                  : _inflateTo(compressedPath, out);
+            out.close();
+        }
+
+        if (total == 0 || !LittleFS.rename(path + ".tmp", path)) {
+            Serial.printf("⚠️ Falha ao descomprimir %s\n", compressedPath.c_str());
+            LittleFS.remove(path + ".tmp");
+            continue;
+        }
+        LittleFS.remove(compressedPath);
+        entry.compression = LogCompression::NONE;
+        entry.bytes = total;
+        entry.modified = (uint32_t)time(nullptr);
+        reopened = true;
+        Serial.printf("🗜️ Dia reaberto para escrita: %s\n", path.c_str());
+    }
+    return reopened;
+}
+
+// --- RETENÇÃO ---
+
+// Dias entre dois AAAAMMDD (ao meio-dia, para a mudança de hora não contar)
+static int _daysBetween(uint32_t from, uint32_t to) {
+    struct tm a = {};
+    a.tm_year = from / 10000 - 1900;
+    a.tm_mon = from / 100 % 100 - 1;
+    a.tm_mday = from % 100;
+    a.tm_hour = 12;
+    a.tm_isdst = -1;
+    struct tm b = a;
+    b.tm_year = to / 10000 - 1900;
+    b.tm_mon = to / 100 % 100 - 1;
+    b.tm_mday = to % 100;
+    return (int)((mktime(&b) - mktime(&a) + 43200) / 86400);
+}
+
+static void _closeDownsample(LogDownsample& job) {
+    job.lines.close();
+    job.dst.close();
+    LittleFS.remove(job.tmpPath);
+}
+
+static void _abortDownsample() {
+    if (!_downsample) return;
+    _closeDownsample(*_downsample);
+    delete _downsample;
+    _downsample = nullptr;
+}
+
+// Leitores abertos fora do logger (os trabalhos em segundo plano também leem com LogFileReader)
+static int _externalReaders() {
+    int readers = logFilesInUse();
+    if (_compaction && _compaction->lines.isOpen()) readers--;
+    if (_downsample && _downsample->lines.isOpen()) readers--;
+    return readers;
+}
+
+// Falta de espaço: escrita falhada, LittleFS abaixo de minFreeBytes ou logs acima de maxBytes
+static bool _retentionOverSpace() {
+    if (_retentionUrgent) return true;
+    if (_retention.minFreeBytes > 0) {
+        size_t total = LittleFS.totalBytes();
+        size_t used = LittleFS.usedBytes();
+        if (used >= total || total - used < _retention.minFreeBytes) return true;
+    }
+    if (_retention.maxBytes > 0) {
+        uint32_t bytes = 0;
+        for (const LogCatalogEntry& entry : _catalog) bytes += entry.bytes;
+        if (bytes > _retention.maxBytes) return true;
+    }
+    return false;
+}
+
+// Apaga o diretório de um dia fechado. Ficheiros que não saem (abertos por um leitor) ficam no manifesto.
+static bool _deleteLogDay(uint32_t day, const char* reason) {
+    if (_compaction && _compaction->entry.day == day) _abortCompaction();
+    if (_downsample && _downsample->entry.day == day) _abortDownsample();
+
+    String dirPath = _dayDirPath(day);
+    uint32_t records = 0;
+    for (const LogCatalogEntry& entry : _catalog) {
+        if (entry.day == day) records += entry.records;
+    }
+
+    std::vector<String> files;
+    File dir = LittleFS.open(dirPath);
+    if (dir && dir.isDirectory()) {
+        File f = dir.openNextFile();
+        while (f) {
+            if (!f.isDirectory()) files.push_back(dirPath + "/" + _fileBaseName(String(f.name())));
+            f.close();
+            f = dir.openNextFile();
+        }
+    }
+    dir.close();
+
+    size_t removed = 0;
+    for (const String& path : files) {
+        if (LittleFS.remove(path)) removed++;
+    }
+
+    std::map<String, LogFileCount> counts;
+    if (removed < files.size() || !LittleFS.rmdir(dirPath)) {
+        if (_loadDayCounts(dirPath, counts, false)) _writeDayCounts(dirPath, counts);
+        Serial.printf("⚠️ Retenção: %u ficheiro(s) de %s ficam para a próxima\n",
+                      (unsigned)(files.size() - removed), dirPath.c_str());
+    }
+    _catalogSetDay(day, counts);
+    for (const auto& kv : counts) records -= kv.second.records;
+    _totalRecords -= records;
+    if (counts.empty()) dropSyncDayMarks(day);
+
+    Serial.printf("🧹 %s apagado (%s): %u registros.\n", dirPath.c_str(), reason, (unsigned)records);
+    return removed > 0;
+}
+
+// Primeiro ficheiro, do dia mais antigo, já com idade de agregação e com mais de um registo por intervalo
+static bool _startDownsample(uint32_t today) {
+    uint32_t maxRecords = 86400UL / _retention.aggregateIntervalSec + 1;
+    for (const LogCatalogEntry& entry : _catalog) {
+        if (entry.day >= today || _daysBetween(entry.day, today) < _retention.aggregateAfterDays) break;
+        if (entry.records <= maxRecords) continue;
+        String path = logCatalogPath(entry);
+        if (std::find(_downsampleSkipped.begin(), _downsampleSkipped.end(), path) != _downsampleSkipped.end()) continue;
+
+        _downsample = new LogDownsample();
+        LogDownsample& job = *_downsample;
+        job.entry = entry;
+        job.srcPath = path;
+        job.outPath = logUncompressedName(path);
+        job.tmpPath = job.outPath + ".agg.tmp";
+        job.headerReady = false;
+        job.bucketCount = 0;
+        job.out = entry;
+        job.out.compression = LogCompression::NONE;
+        job.out.bytes = 0;
+        job.out.records = 0;
+        job.written = false;
+        job.sourceRecords = 0;
+        job.dst = LittleFS.open(job.tmpPath, "w");
+        if (job.dst && job.lines.open(job.srcPath)) return true;
+
+        Serial.printf("⚠️ Agregação: falha ao abrir %s\n", path.c_str());
+        _downsampleSkipped.push_back(path);
+        _abortDownsample();
+    }
+    return false;
+}
+
+// Grava a média do intervalo acumulado, com o timestamp do início do intervalo;
+// 'sourceEnd' = registos do original lidos até ao fim do intervalo (para as marcas de sync)
+static bool _emitDownsampleBucket(LogDownsample& job, uint32_t sourceEnd) {
+    if (job.bucketCount == 0) return true;
+    LogRecord record;
+    encodeLogRecord(record, job.bucketStart, job.sensorIndex, (int)lround((double)job.rawSum / job.bucketCount),
+                    (float)(job.valueSum / job.bucketCount));
+    size_t len = _writeLogRecord(job.dst, job.entry.binary, job.header, job.sensorIndex, record);
+    job.bucketCount = 0;
+    if (len == 0) return false;
+
+    if (job.out.records == 0) job.out.firstTs = record.timestamp;
+    job.out.lastTs = record.timestamp;
+    job.out.records++;
+    job.out.bytes += len;
+    job.sourceEnds.push_back(sourceEnd);
+    return true;
+}
+
+// Agrega um pedaço do ficheiro; 'more' fica false quando chega ao fim
+static bool _downsampleChunk(LogDownsample& job, bool& more) {
+    char line[LOG_LINE_MAX];
+    size_t done = 0;
+    size_t len = 0;
+    while (done < LOG_COMPACT_STEP_BYTES && (len = job.lines.readNextLine(line, sizeof(line))) > 0) {
+        done += len;
+        uint32_t ordinal = job.sourceRecords++; // o sync conta as mesmas linhas
+        LogRecord record;
+        if (!_parseLogLine(line, record, job.headerReady ? nullptr : &job.header) || record.timestamp == 0) continue;
+        if (!job.headerReady) {
+            char sensorId[sizeof(job.header.sensorId) + 1] = {};
+            memcpy(sensorId, job.header.sensorId, sizeof(job.header.sensorId));
+            job.sensorIndex = _logSensorIndexOf(String(sensorId));
+            if (job.entry.binary) {
+                if (job.dst.write((const uint8_t*)&job.header, sizeof(job.header)) != sizeof(job.header)) return false;
+                job.out.bytes += sizeof(job.header);
+            }
+            job.headerReady = true;
+        }
+
+        uint32_t bucket = record.timestamp - record.timestamp % _retention.aggregateIntervalSec;
+        if (job.bucketCount > 0 && bucket != job.bucketStart && !_emitDownsampleBucket(job, ordinal)) return false;
+        if (job.bucketCount == 0) {
+            job.bucketStart = bucket;
+            job.rawSum = 0;
+            job.valueSum = 0;
+        }
+        job.rawSum += record.raw;
+        job.valueSum += record.value;
+        job.bucketCount++;
+    }
+    more = len > 0;
+    return more || _emitDownsampleBucket(job, job.sourceRecords);
+}
+
+// Um passo da agregação em curso: agrega um pedaço ou, no fim, troca o ficheiro e atualiza o catálogo
+static void _downsampleStep() {
+    LogDownsample& job = *_downsample;
+    if (!job.written) {
+        bool more = false;
+        bool ok = _downsampleChunk(job, more);
+        if (ok && more) return;
+
+        job.lines.close();
+        job.dst.close();
+        if (!ok || job.out.records == 0 || job.out.records >= job.entry.records) {
+            Serial.printf("⚠️ Agregação de %s %s; fica como está.\n", job.srcPath.c_str(),
+                          ok ? "não reduz os registos" : "falhou a gravação");
+            _downsampleSkipped.push_back(job.srcPath);
+            _abortDownsample();
+            return;
+        }
+        job.written = true;
+    }
+
+    if (logFilesInUse() > 0) return; // como na compactação: um leitor a meio não perde o ficheiro
+
+    // Se faltar a energia entre o rename e o remove, o arranque apaga o resultado (o .col/.gz manda) e a agregação repete-se
+    if (!LittleFS.rename(job.tmpPath, job.outPath)) {
+        Serial.printf("⚠️ Agregação: falha ao renomear %s\n", job.tmpPath.c_str());
+        _downsampleSkipped.push_back(job.srcPath);
+        _abortDownsample();
+        return;
+    }
+    if (job.srcPath != job.outPath) LittleFS.remove(job.srcPath);
+    LittleFS.remove(logIndexPathFor(job.outPath)); // offsets do original
+
+    LogCatalogEntry& entry = _catalogEntryFor(job.entry.day, _catalogSensors[job.entry.sensor], job.entry.binary);
+    _totalRecords -= entry.records - job.out.records;
+    entry = job.out;
+    entry.modified = (uint32_t)time(nullptr);
+    _writeDayCounts(_dayDirPath(job.entry.day), _catalogDayCounts(job.entry.day));
+    remapSyncFileMarks(job.entry, job.sourceEnds); // as marcas contavam registos do original
+
+    Serial.printf("🧹 Agregado %s: %u -> %u registros (médias de %us)\n", job.srcPath.c_str(),
+                  (unsigned)job.entry.records, (unsigned)job.out.records, (unsigned)_retention.aggregateIntervalSec);
+    delete _downsample;
+    _downsample = nullptr;
+}
+
+// Uma ação da política: apagar um dia (falta de espaço, depois idade) ou começar uma agregação
+static bool _retentionStep() {
+    uint32_t today = _todayKey();
+    if (today == 0) return false;
+
+    uint32_t oldest = 0; // dia fechado mais antigo (o de hoje nunca é apagado)
+    if (!_catalog.empty() && _catalog.front().day < today) oldest = _catalog.front().day;
+
+    if (_retentionOverSpace()) {
+        if (oldest == 0) {
+            if (!_retentionStuck) Serial.println("⚠️ Retenção: sem espaço e sem dias fechados para apagar.");
+            _retentionStuck = true;
+            _retentionUrgent = false;
+            return false;
+        }
+        // Falta de espaço não espera pelos leitores: a amostragem está primeiro
+        bool deleted = _deleteLogDay(oldest, "espaço");
+        _retentionUrgent = false;
+        for (auto& slot : _writeSlots) _flushSlot(slot); // o que ficou no buffer (volta a marcar urgente se ainda falhar)
+        return deleted;
+    }
+    _retentionStuck = false;
+
+    if (_retention.maxDays > 0 && oldest != 0 && _daysBetween(oldest, today) >= _retention.maxDays) {
+        if (_externalReaders() > 0) return false;
+        return _deleteLogDay(oldest, "idade");
+    }
+
+    if (_retention.aggregateAfterDays > 0 && !_downsample && !_compaction) return _startDownsample(today);
+    return false;
+}
+
+void loopDataLogger() {
+    LogLock lock;
+    unsigned long now = millis();
+    bool flushed = false;
+    for (auto& slot : _writeSlots) {
+        if (slot.used > 0 && now - slot.firstBufferedMillis >= LOG_FLUSH_INTERVAL_MS) {
+            _flushSlot(slot);
+            flushed = true;
+        }
+    }
+    // O manifesto acompanha os dados gravados (no máximo uma escrita por intervalo)
+    if (flushed) _saveDayCounts();
+
+    // Retenção antes da compactação, um trabalho de cada vez; falta de espaço interrompe a agregação
+    bool retentionDue = now - _lastRetentionCheck >= (_retentionUrgent ? LOG_RETENTION_URGENT_MS : LOG_RETENTION_CHECK_MS);
+    if (retentionDue && (!_downsample || _retentionUrgent)) {
+        if (!_retentionStep()) _lastRetentionCheck = now;
+    }
+    if (_downsample) {
+        _downsampleStep();
+        return;
+    }
+
+    // Compactação em segundo plano: um pedaço por chamada; sem trabalho, volta a procurar mais tarde
+    if (_compression == LogCompression::NONE) return;
+    if (!_compaction && now - _lastCompactionCheck >= LOG_COMPACT_CHECK_MS) {
+        if (!_startCompaction()) _lastCompactionCheck = now;
+    }
+    if (_compaction) _compactionStep();
+}
+
+uint32_t compactClosedLogFiles() {
+    LogLock lock;
+    flushLogs();
+
+    uint32_t compacted = 0;
+    while (_compaction || _startCompaction()) {
+        CompactionResult result = _compactionStep();
+        if (result == COMPACT_DONE) compacted++;
+        if (result == COMPACT_WAITING) break; // fica para o loopDataLogger quando os leitores fecharem
+    }
+    Serial.printf("🗜️ Compactação: %u ficheiro(s) comprimidos.\n", (unsigned)compacted);
+    return compacted;
+}
+
+uint32_t applyLogRetention() {
+    LogLock lock;
+    flushLogs();
+
+    uint32_t actions = 0;
+    while (_downsample || _retentionStep()) {
+        if (!_downsample) {
+            actions++; // dia apagado
+            continue;
+        }
+        while (_downsample && !_downsample->written) _downsampleStep();
+        if (!_downsample) continue; // ignorado: não reduz ou falhou
+        _downsampleStep();
+        if (_downsample) break; // à espera dos leitores: fica para o loopDataLogger
+        actions++;
+    }
+    Serial.printf("🧹 Retenção: %u dia(s) apagados ou agregados.\n", (unsigned)actions);
+    return actions;
+}
+
+uint32_t deleteLogDaysBefore(uint32_t day) {
+    LogLock lock;
+    uint32_t today = _todayKey();
+    uint32_t deleted = 0;
+    while (!_catalog.empty() && _catalog.front().day < day && _catalog.front().day < today) {
+        uint32_t oldest = _catalog.front().day;
+        _deleteLogDay(oldest, "sincronizado");
+        if (!_catalog.empty() && _catalog.front().day == oldest) break; // ficheiros abertos por um leitor
+        deleted++;
+    }
+    return deleted;
+}
+
+uint32_t getTotalRecordCount() {
+    return _totalRecords;
+}
+
+uint32_t countRecordsInRange(time_t since, time_t until) {
+    if (since == 0 && until == 0) return getTotalRecordCount();
+
+    LogLock lock;
+    flushLogs();
+
+    uint32_t total = 0;
+    for (const LogCatalogEntry& entry : findLogCatalogEntries(String(), since, until)) {
+        // Ficheiro inteiro dentro do intervalo: a contagem sai do catálogo
+        if ((since == 0 || (time_t)entry.firstTs >= since) && (until == 0 || (time_t)entry.lastTs <= until)) {
+            total += entry.records;
+            continue;
+        }
+        // Ficheiro nas bordas: conta só os registos do intervalo, a partir do índice
+        LogFileReader reader;
+        if (!reader.open(logCatalogPath(entry))) continue;
+        reader.setTimeRange(since, until);
+        char line[LOG_LINE_MAX];
+        while (reader.readNextLine(line, sizeof(line)) > 0) total++;
+        reader.close();
+    }
+    return total;
+}
+
+uint32_t rebuildRecordManifest() {
+    LogLock lock;
+    flushLogs();
+    _abortCompaction(); // o item copiado do catálogo deixaria de valer
+    _abortDownsample();
+    _totalRecords = _loadAllCounts(true); // também remonta o catálogo
+    _dayCountsDirty = false;
+    Serial.printf("ℹ️ Manifesto reconstruído: %u registros.\n", (unsigned)_totalRecords);
+    return _totalRecords;
 }
 
 // Ajusta o relógio do ESP32
@@ -105,6 +1433,21 @@ void setSystemTime(time_t epochTime) {
 // Em src/data_logger.cpp
 
 void deleteLogFiles() {
+    LogLock lock;
+    // Fecha os handles do write-behind (e a compactação em curso) antes de apagar os ficheiros
+    _closeAllSlots();
+    _abortCompaction();
+    _abortDownsample();
+    _compactionSkipped.clear();
+    _downsampleSkipped.clear();
+    _currentDayKey = 0;
+    _catalog.clear();
+    _catalogSensors.clear();
+    _dayCountsDir = "";
+    _dayCountsDirty = false;
+    _totalRecords = 0;
+    clearSyncWatermarks(); // as contagens confirmadas referiam-se aos ficheiros apagados
+
     int totalCount = 0;
     File root = LittleFS.open(LOG_DIR);
     if (!root || !root.isDirectory()) {
@@ -152,7 +1495,8 @@ void deleteLogFiles() {
 }
 
 
-// Conta total de registros em todos os arquivos de log
+// Conta total de registros em todos os arquivos de log (varredura completa).
+// O SOT usa getTotalRecordCount(); esta função fica para verificar o manifesto.
 int getTotalRecordsInAllFiles() {
     int totalCount = 0;
     File root = LittleFS.open(LOG_DIR);
@@ -168,7 +1512,19 @@ int getTotalRecordsInAllFiles() {
 
             File f = dir.openNextFile();
             while(f) {
-                if(!f.isDirectory()) {
+                if(!f.isDirectory() && String(f.name()).endsWith(LOG_BIN_EXT)) {
+                    // Registos binários têm largura fixa: a contagem sai do tamanho do ficheiro
+                    Serial.printf("   📄 Arquivo: %s\n", f.name());
+                    if (f.size() > sizeof(LogFileHeader)) {
+                        totalCount += (f.size() - sizeof(LogFileHeader)) / sizeof(LogRecord);
+                    }
+                } else if(!f.isDirectory() && isCompressedLogFileName(String(f.name()))) {
+                    // Dia compactado: conta descomprimindo
+                    Serial.printf("   📄 Arquivo: %s\n", f.name());
+                    String filePath = String(LOG_DIR) + "/" + _fileBaseName(String(dir.name())) + "/" + _fileBaseName(String(f.name()));
+                    f.close();
+                    totalCount += _countRecordsInFile(filePath);
+                } else if(!f.isDirectory() && isLogFileName(String(f.name()))) {
                     Serial.printf("   📄 Arquivo: %s\n", f.name());
 
                     while(f.available()) {
@@ -191,44 +1547,27 @@ int getTotalRecordsInAllFiles() {
 
 // Funções auxiliares para BLE
 bool openLogFileForRead(const String& filePath) {
-    logFileBLE = LittleFS.open(filePath, "r");
-    return logFileBLE;
+    return logReaderBLE.open(filePath);
 }
 
 String readNextLogEntry() {
-    return (logFileBLE && logFileBLE.available()) ? logFileBLE.readStringUntil('\n') : "";
+    return logReaderBLE.readNextLine();
 }
 
 void closeLogFile() {
-    if (logFileBLE) logFileBLE.close();
+    logReaderBLE.close();
 }
 
 /// Obtém uma lista com o caminho absoluto de todos os ficheiros de log.
 std::vector<String> getAllLogFilePaths() {
-    std::vector<String> filePaths;
-    File root = LittleFS.open(LOG_DIR, "r");
-    if (!root || !root.isDirectory()) {
-        return filePaths;
-    }
+    return listLogFilePaths(String(), 0, 0);
+}
 
-    File dateDir = root.openNextFile();
-    while(dateDir){
-        if(dateDir.isDirectory()){
-            File logDir = LittleFS.open(dateDir.name());
-            File logFile = logDir.openNextFile();
-            while(logFile){
-                if(!logFile.isDirectory() && String(logFile.name()).endsWith(".jsonl")){
-                    filePaths.push_back(String(logFile.name()));
-                }
-                logFile.close();
-                logFile = logDir.openNextFile();
-            }
-            logDir.close();
-        }
-        dateDir.close();
-        dateDir = root.openNextFile();
+std::vector<String> listLogFilePaths(const String& sensorId, time_t since, time_t until) {
+    std::vector<String> filePaths;
+    for (const LogCatalogEntry& entry : findLogCatalogEntries(sensorId, since, until)) {
+        filePaths.push_back(logCatalogPath(entry));
     }
-    root.close();
     return filePaths;
 }
 
@@ -251,96 +1590,102 @@ void streamFileJson(AsyncResponseStream* response, File &file, const String &fil
     response->write("\"}\n", 3);
 }
 
-void prepareLogStream() {
-    Serial.println("Preparando stream de logs...");
-    _streamFilePaths.clear();
-    _currentStreamFileIndex = -1;
-    _isFirstChunk = true;
+// --- LogStreamCursor ---
 
-    File root = LittleFS.open(LOG_DIR);
-    if (!root || !root.isDirectory()) return;
-
-    File dateDir = root.openNextFile();
-    while(dateDir){
-        if(dateDir.isDirectory()){
-            File logDir = LittleFS.open(dateDir.name());
-            File logFile = logDir.openNextFile();
-            while(logFile){
-                if(!logFile.isDirectory() && String(logFile.name()).endsWith(".jsonl")){
-                    _streamFilePaths.push_back(String(logFile.name()));
-                }
-                logFile.close();
-                logFile = logDir.openNextFile();
-            }
-            logDir.close();
+LogStreamCursor::LogStreamCursor()
+    : _nextFile(0), _since(0), _until(0), _records(0), _started(false), _finished(true),
+      _pendingLen(0), _pendingPos(0) {}
+
+void LogStreamCursor::begin(const String& sensorId, time_t since, time_t until) {
+    LogLock lock;
+    flushLogs(); // o stream inclui o que ainda estava no buffer de escrita
+
+    _reader.close();
+    _filePaths = listLogFilePaths(sensorId, since, until);
+    _nextFile = 0;
+    _since = since;
+    _until = until;
+    _records = 0;
+    _started = false;
+    _finished = false;
+    _pendingLen = 0;
+    _pendingPos = 0;
+}
+
+bool LogStreamCursor::_openNextFile() {
+    while (_nextFile < _filePaths.size()) {
+        if (_reader.open(_filePaths[_nextFile++])) {
+            _reader.setTimeRange(_since, _until);
+            return true;
         }
-        dateDir.close();
-        dateDir = root.openNextFile();
     }
-    root.close();
-    Serial.printf("Encontrados %d ficheiros de log para o stream.\n", _streamFilePaths.size());
+    return false;
 }
 
-size_t readLogStreamChunk(uint8_t *buffer, size_t maxLen) {
-    size_t bytesWritten = 0;
+size_t LogStreamCursor::read(uint8_t* buffer, size_t maxLen) {
+    // Um chunk de cada vez: o logger não grava a meio de uma linha lida aqui
+    LogLock lock;
+    char* out = (char*)buffer;
+    size_t written = 0;
 
-    // Se for o primeiro pedaço de todos, envia o '[' de abertura do array JSON
-    if (_isFirstChunk) {
-        buffer[bytesWritten++] = '[';
-        _isFirstChunk = false;
-    }
+    while (written < maxLen) {
+        if (_pendingPos < _pendingLen) {
+            size_t n = std::min(_pendingLen - _pendingPos, maxLen - written);
+            memcpy(out + written, _pending + _pendingPos, n);
+            _pendingPos += n;
+            written += n;
+            continue;
+        }
+        _pendingLen = 0;
+        _pendingPos = 0;
 
-    while (bytesWritten < maxLen) {
-        // Se não houver ficheiro aberto, tenta abrir o próximo da lista
-        if (!_currentStreamFile) {
-            _currentStreamFileIndex++;
-            if (_currentStreamFileIndex >= _streamFilePaths.size()) {
-                // Não há mais ficheiros, termina o stream
-                break; 
-            }
-            _currentStreamFile = LittleFS.open(_streamFilePaths[_currentStreamFileIndex], "r");
-            if (!_currentStreamFile) continue;
+        if (_finished) break;
+
+        if (!_started) {
+            out[written++] = '[';
+            _started = true;
+            continue;
         }
 
-        // Se o ficheiro atual não tiver mais nada, fecha-o e passa para o próximo
-        if (!_currentStreamFile.available()) {
-            _currentStreamFile.close();
+        if (!_reader.isOpen() && !_openNextFile()) {
+            out[written++] = ']';
+            _finished = true;
             continue;
         }
 
-        // Lê a próxima linha do ficheiro
-        String line = _currentStreamFile.readStringUntil('\n');
-        if (line.length() > 2) {
-            // Adiciona a vírgula se não for o primeiro elemento do array JSON
-            if (bytesWritten > 1) { // Maior que 1 para não adicionar vírgula depois do '[' inicial
-                if (bytesWritten + 1 < maxLen) {
-                    buffer[bytesWritten++] = ',';
-                } else break;
-            }
+        // Se a linha inteira couber no que resta, é decodificada direto no buffer de saída
+        size_t sep = _records > 0 ? 1 : 0;
+        bool direct = (maxLen - written) >= sep + LOG_LINE_MAX;
+        char* dst = direct ? out + written : _pending;
 
-            // Copia a linha para o buffer, se houver espaço
-            if (bytesWritten + line.length() < maxLen) {
-                memcpy(buffer + bytesWritten, line.c_str(), line.length());
-                bytesWritten += line.length();
-            } else {
-                // Se a linha não couber, volta a colocar no ficheiro e termina este chunk
-                _currentStreamFile.seek(_currentStreamFile.position() - line.length() - 1);
-                break;
-            }
+        size_t len = _reader.readNextLine(dst + sep, LOG_LINE_MAX);
+        if (len == 0) {
+            _reader.close();
+            continue;
         }
-    }
+        if (sep) dst[0] = ',';
+        _records++;
 
-    // Se terminámos todos os ficheiros e ainda há espaço no buffer, envia o ']' de fecho
-    if (_currentStreamFileIndex >= _streamFilePaths.size() && bytesWritten + 1 < maxLen) {
-        buffer[bytesWritten++] = ']';
-        // Marca o índice como "superado" para indicar que terminámos
-        _currentStreamFileIndex++; 
+        if (direct) written += sep + len;
+        else _pendingLen = sep + len;
     }
+    return written;
+}
 
-    // Se terminámos e não escrevemos nada (nem o '['), retorna 0
-    if (bytesWritten == 0 && _currentStreamFileIndex > _streamFilePaths.size()) {
-        return 0;
-    }
+size_t LogStreamCursor::fileCount() const {
+    return _filePaths.size();
+}
+
+uint32_t LogStreamCursor::recordCount() const {
+    return _records;
+}
+
+void prepareLogStream(const String& sensorId, time_t since, time_t until) {
+    Serial.println("Preparando stream de logs...");
+    _logStream.begin(sensorId, since, until);
+    Serial.printf("Encontrados %u ficheiros de log para o stream.\n", (unsigned)_logStream.fileCount());
+}
 
-    return bytesWritten;
-}
\ No newline at end of file
+size_t readLogStreamChunk(uint8_t *buffer, size_t maxLen) {
+    return _logStream.read(buffer, maxLen);
+}
@@ -5,20 +5,108 @@
 #include <FS.h>
 #include "time.h"
 #include <ESPAsyncWebServer.h>
+#include "log_format.h"
+#include <vector>
 extern const char* LOG_DIR;
 // Funções de configuração e escrita
 void setupDataLogger();
 void setSystemTime(time_t epochTime);
-void deleteLogFiles(); // Apaga todos os logs
-void logSensorReading(time_t timestamp, const String& sensorId, const String& unit, int rawValue, float calibratedValue);
+void deleteLogFiles(); // Apaga todos os logs (e as marcas de sync dos clientes)
+uint32_t deleteLogDaysBefore(uint32_t day); // Apaga os dias fechados anteriores a 'day' (AAAAMMDD); retorna quantos
+void registerLogSensor(const String& sensorId); // Define o sensorIndex gravado nos registos binários
+void logSensorReading(time_t timestamp, const String& sensorId, const String& sensorType, const String& unit, int rawValue, float calibratedValue);
+void flushLogs(); // Grava no flash tudo o que está no buffer de escrita (antes de ler ou desligar)
+void loopDataLogger(); // Grava os buffers parados há mais de LOG_FLUSH_INTERVAL_MS, aplica a retenção e compacta dias fechados
+uint32_t compactClosedLogFiles(); // Comprime já todos os dias fechados (manutenção e benchmark)
+uint32_t applyLogRetention(); // Aplica já a política de retenção do HubConfig (apaga e agrega dias antigos)
+
+// Leitores noutras tarefas (sync BLE) tomam o mutex do logger só durante cada leitura,
+// para não ver um ficheiro a meio de uma escrita nem bloquear a amostragem por muito tempo
+void lockLogs();
+void unlockLogs();
+struct LogReadLock {
+    LogReadLock() { lockLogs(); }
+    ~LogReadLock() { unlockLogs(); }
+};
+
+/**
+ * @brief Ficheiro de log no catálogo em RAM (um por dia, sensor e formato).
+ * O catálogo é montado em setupDataLogger() a partir dos manifestos e atualizado a cada
+ * gravação e remoção, para listar e paginar o histórico sem percorrer /logs.
+ */
+struct LogCatalogEntry {
+    uint32_t day;      // AAAAMMDD
+    uint16_t sensor;   // posição do sensorId no catálogo (ver logCatalogSensorId)
+    bool binary;
+    LogCompression compression; // dia fechado já compactado (<ficheiro>.gz ou .col); 'bytes' é o tamanho no flash
+    uint32_t bytes;
+    uint32_t records;
+    uint32_t firstTs;  // epoch do primeiro e do último registo (0 = ficheiro sem registos)
+    uint32_t lastTs;
+    uint32_t modified; // epoch da última escrita do ficheiro (o mtime, sem o abrir)
+};
+
+size_t getLogCatalogSize();
+bool getLogCatalogEntry(size_t index, LogCatalogEntry& entry); // índice em ordem cronológica
+// Cópia dos itens do sensor (vazio = todos) com registos em [since, until] (0 = sem limite)
+std::vector<LogCatalogEntry> findLogCatalogEntries(const String& sensorId, time_t since, time_t until);
+String logCatalogSensorId(const LogCatalogEntry& entry);
+String logCatalogFileName(const LogCatalogEntry& entry);
+String logCatalogPath(const LogCatalogEntry& entry);
+
 // Funções de leitura para o processo de sincronização BLE
+uint32_t getTotalRecordCount(); // Total mantido pelo manifesto (O(1))
+uint32_t rebuildRecordManifest(); // Reconta todos os ficheiros e regrava os manifestos
+uint32_t countRecordsInRange(time_t since, time_t until); // Registos em [since, until] (0 = sem limite)
 int getTotalRecordsInAllFiles();
 bool openLogFileForRead(const String& filePath);
 String readNextLogEntry();
 void closeLogFile();
 void streamAllLogFiles(AsyncResponseStream *response);
 std::vector<String> getAllLogFilePaths();
+
+// Ficheiros de log em ordem cronológica (dia e depois nome), filtrados por sensor e intervalo (vazio/0 = todos)
+std::vector<String> listLogFilePaths(const String& sensorId, time_t since, time_t until);
+
+/**
+ * @brief Cursor que exporta todos os registos dos logs como um único array JSON.
+ * Cada pedido HTTP tem o seu; prepareLogStream()/readLogStreamChunk() usam uma instância global.
+ */
+class LogStreamCursor {
+public:
+    LogStreamCursor();
+
+    // Lista os ficheiros e recomeça o array (sensorId vazio e since/until 0 = sem filtro)
+    void begin(const String& sensorId = String(), time_t since = 0, time_t until = 0);
+
+    /**
+     * @brief Enche o buffer até maxLen com a continuação do array ('[', registos, ']').
+     * Linhas que não cabem no que resta passam para a chamada seguinte.
+     * @return Bytes escritos; 0 só depois do ']' de fecho.
+     */
+    size_t read(uint8_t* buffer, size_t maxLen);
+
+    size_t fileCount() const;
+    uint32_t recordCount() const;
+
+private:
+    bool _openNextFile();
+
+    std::vector<String> _filePaths;
+    size_t _nextFile;
+    LogFileReader _reader;
+    time_t _since;
+    time_t _until;
+    uint32_t _records;
+    bool _started;
+    bool _finished;
+
+    char _pending[LOG_LINE_MAX + 1];
+    size_t _pendingLen;
+    size_t _pendingPos;
+};
+
 size_t readLogStreamChunk(uint8_t *buffer, size_t maxLen);
-void prepareLogStream();
+void prepareLogStream(const String& sensorId = String(), time_t since = 0, time_t until = 0);
 
 #endif
\ No newline at end of file
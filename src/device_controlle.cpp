@@ -1,6 +1,10 @@
 #include "device_controller.h"
+#include "data_logger.h"
+#include "hub_config.h"
 #include <LittleFS.h>
 #include <ArduinoJson.h>
+#include <algorithm>
+#include <climits>
 
 DeviceController::DeviceController() :
     sensor_pressure(nullptr),
@@ -8,7 +12,10 @@ DeviceController::DeviceController() :
     sensor_tds(nullptr),
     sensor_temperature(nullptr),
     sensor_volume(nullptr),
-    _isReady(false)
+    _schedulerStarted(false),
+    _isReady(false),
+    _rollupWindowCount(0),
+    _rollupPruneDay(0)
 {}
 
 DeviceController::~DeviceController() {
@@ -102,6 +109,11 @@ bool DeviceController::init() {
         return false;
     }
 
+    // Regista a ordem dos sensores para o índice gravado nos logs binários
+    for (const auto sensor : _sensors) {
+        if (sensor) registerLogSensor(sensor->getSensorId());
+    }
+
     long minPeriodSec = 99999999;
 
     // 3. Itera sobre todos os objetos de sensor que foram criados
@@ -123,6 +135,14 @@ bool DeviceController::init() {
         _realtimeNotifyIntervalMs = minPeriodSec * 1000L;
     }
 
+    // 7. Uma janela de agregados aberta por sensor e por duração de "rollup" em hub_config.json
+    const RollupConfig& rollup = HubConfig::getInstance().getRollup();
+    _rollupWindowCount = rollup.windowCount;
+    _rollups.assign(_sensors.size() * _rollupWindowCount, RollupStats());
+    for (size_t i = 0; i < _rollups.size(); i++) {
+        _rollups[i].reset(0, rollup.windowsSec[i % _rollupWindowCount]);
+    }
+
     _isReady = true; // Mesmo que algum sensor falhe, o hub fica pronto
     return true;
 }
@@ -133,3 +153,234 @@ const std::vector<Sensor*>& DeviceController::getSensors() const { return _senso
 long DeviceController::getMinSamplingInterval(){
     return _realtimeNotifyIntervalMs;
 }
+
+
+// --- AGENDADOR DE AMOSTRAGEM ---
+
+// Ordem da heap: o prazo mais próximo fica no topo (comparação segura com o overflow de millis())
+static bool laterDeadline(unsigned long a, unsigned long b) {
+    return (long)(a - b) > 0;
+}
+
+void DeviceController::_pushTask(const ScheduledTask& task) {
+    _schedule.push_back(task);
+    std::push_heap(_schedule.begin(), _schedule.end(), [](const ScheduledTask& a, const ScheduledTask& b) {
+        return laterDeadline(a.dueMillis, b.dueMillis);
+    });
+}
+
+void DeviceController::_startScheduler() {
+    _schedule.clear();
+    _schedule.reserve(_sensors.size() * 2);
+
+    // Primeira leitura de cada sensor imediatamente, como antes
+    unsigned long now = millis();
+    for (Sensor* sensor : _sensors) {
+        if (!sensor) continue;
+        if (sensor->getSamplingPeriodMs() > 0) _pushTask({now, sensor, ScheduledAction::SAMPLE});
+        if (sensor->getNotifyPeriodMs() > 0) _pushTask({now, sensor, ScheduledAction::NOTIFY});
+    }
+    _schedulerStarted = true;
+}
+
+unsigned long DeviceController::runScheduler() {
+    if (!_schedulerStarted) _startScheduler();
+    if (_schedule.empty()) return ULONG_MAX;
+
+    auto heapOrder = [](const ScheduledTask& a, const ScheduledTask& b) {
+        return laterDeadline(a.dueMillis, b.dueMillis);
+    };
+
+    unsigned long now = millis();
+    while (!_schedule.empty() && !laterDeadline(_schedule.front().dueMillis, now)) {
+        std::pop_heap(_schedule.begin(), _schedule.end(), heapOrder);
+        ScheduledTask task = _schedule.back();
+        _schedule.pop_back();
+
+        unsigned long period;
+        if (task.action == ScheduledAction::SAMPLE) {
+            task.sensor->sample();
+            _updateRollups(task.sensor);
+            period = task.sensor->getSamplingPeriodMs();
+        } else {
+            task.sensor->notifyIfChanged();
+            period = task.sensor->getNotifyPeriodMs();
+        }
+
+        // Próximo prazo sem deriva; se ficou mais de um período para trás, recomeça a partir de agora
+        now = millis();
+        task.dueMillis += period;
+        if (laterDeadline(now, task.dueMillis)) task.dueMillis = now + period;
+        _pushTask(task);
+    }
+
+    return laterDeadline(_schedule.front().dueMillis, now) ? _schedule.front().dueMillis - now : 0;
+}
+
+// --- AMOSTRAS RECENTES ---
+
+Sensor* DeviceController::findSensor(const String& sensorId) const {
+    for (Sensor* sensor : _sensors) {
+        if (sensor && sensor->getSensorId() == sensorId) return sensor;
+    }
+    return nullptr;
+}
+
+size_t DeviceController::getRecentSamples(const String& sensorId, size_t lastN, SensorSample* out, size_t maxCount) const {
+    Sensor* sensor = findSensor(sensorId);
+    if (!sensor) return 0;
+    return sensor->getRecentSamples().copyLast(lastN, out, maxCount);
+}
+
+size_t DeviceController::getSamplesSince(const String& sensorId, time_t since, SensorSample* out, size_t maxCount) const {
+    Sensor* sensor = findSensor(sensorId);
+    if (!sensor) return 0;
+    return sensor->getRecentSamples().copySince((uint32_t)since, out, maxCount);
+}
+
+bool DeviceController::recentSamplesToJson(JsonArray array, const String& sensorId, size_t lastN, time_t since) const {
+    if (sensorId.length() > 0 && !findSensor(sensorId)) return false;
+
+    SensorSample samples[SENSOR_RING_CAPACITY];
+    for (Sensor* sensor : _sensors) {
+        if (!sensor) continue;
+        if (sensorId.length() > 0 && sensor->getSensorId() != sensorId) continue;
+
+        const SampleRingBuffer& ring = sensor->getRecentSamples();
+        size_t count = (since != 0)
+            ? ring.copySince((uint32_t)since, samples, SENSOR_RING_CAPACITY)
+            : ring.copyLast(lastN > 0 ? lastN : SENSOR_RING_CAPACITY, samples, SENSOR_RING_CAPACITY);
+
+        JsonObject obj = array.createNestedObject();
+        obj["sensorId"] = sensor->getSensorId();
+        obj["unit"] = sensor->getUnit();
+        JsonArray list = obj.createNestedArray("samples");
+        for (size_t i = 0; i < count; i++) {
+            JsonArray entry = list.createNestedArray();
+            entry.add(samples[i].timestamp);
+            entry.add(samples[i].raw);
+            entry.add(samples[i].value);
+        }
+    }
+    return true;
+}
+
+// --- AGREGADOS ---
+
+// Junta a amostra acabada de gravar às janelas abertas do sensor; a que mudou de janela é gravada no flash
+void DeviceController::_updateRollups(Sensor* sensor) {
+    if (_rollupWindowCount == 0) return;
+    size_t index = std::find(_sensors.begin(), _sensors.end(), sensor) - _sensors.begin();
+    if (index >= _sensors.size()) return;
+
+    SensorSample sample;
+    if (sensor->getRecentSamples().copyLast(1, &sample, 1) == 0) return;
+    if (sample.timestamp < 1704067200) return; // relógio por acertar: a janela seria de 1970
+
+    for (size_t w = 0; w < _rollupWindowCount; w++) {
+        RollupStats& stats = _rollups[index * _rollupWindowCount + w];
+        uint32_t start = sample.timestamp - sample.timestamp % stats.windowSec;
+
+        RollupStats closed;
+        closed.count = 0;
+        portENTER_CRITICAL(&_rollupMux);
+        if (stats.start != start) {
+            closed = stats;
+            stats.reset(start, stats.windowSec);
+        }
+        stats.add(sample.value);
+        portEXIT_CRITICAL(&_rollupMux);
+
+        if (closed.count > 0) appendRollup(sensor->getSensorId(), closed);
+    }
+
+    // Uma vez por dia saem os ficheiros de agregados mais antigos do que "rollup.max_days"
+    uint32_t day = sample.timestamp / 86400;
+    if (day != _rollupPruneDay) {
+        _rollupPruneDay = day;
+        pruneRollupFiles(HubConfig::getInstance().getRollup().maxDays);
+    }
+}
+
+bool DeviceController::rollupsToJson(JsonArray array, const String& sensorId, uint32_t windowSec, time_t since,
+                                     time_t until, size_t maxRecords, time_t& next) const {
+    next = 0;
+    if (sensorId.length() > 0 && !findSensor(sensorId)) return false;
+
+    // Só os dias que enchem a página: o histórico inteiro não cabe na RAM
+    std::vector<RollupEntry> entries = readRollups(sensorId, windowSec, since, until, maxRecords);
+    const bool truncated = entries.size() > maxRecords; // pode haver mais ficheiros por ler
+
+    // Janelas ainda abertas, copiadas da RAM
+    for (size_t i = 0; i < _rollups.size(); i++) {
+        Sensor* sensor = _sensors[i / _rollupWindowCount];
+        if (sensorId.length() > 0 && sensor->getSensorId() != sensorId) continue;
+
+        portENTER_CRITICAL(&_rollupMux);
+        RollupStats stats = _rollups[i];
+        portEXIT_CRITICAL(&_rollupMux);
+
+        if (stats.count == 0) continue;
+        if (windowSec != 0 && stats.windowSec != windowSec) continue;
+        if ((since != 0 && (time_t)stats.start < since) || (until != 0 && (time_t)stats.start > until)) continue;
+        RollupEntry entry = { sensor->getSensorId(), stats.windowSec, stats.start, stats.count,
+                              stats.min, stats.max, stats.mean(), stats.last, true };
+        entries.push_back(entry);
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const RollupEntry& a, const RollupEntry& b) {
+        return a.start < b.start;
+    });
+
+    // Corta numa mudança de início, para o pedido seguinte (since = next) não repetir nem saltar agregados
+    if (entries.size() > maxRecords) {
+        size_t cut = maxRecords;
+        while (cut > 0 && entries[cut].start == entries[cut - 1].start) cut--;
+        if (cut == 0) {
+            // Mais agregados com o mesmo início do que a página: vão todos, senão 'next' nunca avançava
+            cut = maxRecords;
+            while (cut < entries.size() && entries[cut].start == entries[cut - 1].start) cut++;
+        }
+        if (cut < entries.size()) {
+            next = entries[cut].start;
+            entries.resize(cut);
+        } else if (truncated) {
+            next = entries.back().start + 1; // os deste início vieram todos (mesmo ficheiro)
+        }
+    }
+
+    // Um objeto por (sensor, janela), pela ordem em que aparecem
+    std::vector<std::pair<String, uint32_t>> keys;
+    std::vector<JsonObject> groups;
+    std::vector<JsonArray> lists;
+    for (const RollupEntry& entry : entries) {
+        size_t g = 0;
+        while (g < keys.size() && !(keys[g].first == entry.sensorId && keys[g].second == entry.windowSec)) g++;
+        if (g == keys.size()) {
+            keys.push_back(std::make_pair(entry.sensorId, entry.windowSec));
+            JsonObject obj = array.createNestedObject();
+            obj["sensorId"] = entry.sensorId;
+            Sensor* sensor = findSensor(entry.sensorId);
+            if (sensor) obj["unit"] = sensor->getUnit();
+            obj["window"] = entry.windowSec;
+            groups.push_back(obj);
+            lists.push_back(obj.createNestedArray("rollups"));
+        }
+        if (entry.partial) groups[g]["partial"] = true;
+
+        JsonArray item = lists[g].createNestedArray();
+        item.add(entry.start);
+        item.add(entry.count);
+        item.add(entry.min);
+        item.add(entry.max);
+        item.add(entry.mean);
+        item.add(entry.last);
+    }
+    return true;
+}
+
+size_t DeviceController::rollupsJsonCapacity(size_t maxRecords) const {
+    size_t groups = _sensors.size() * (_rollupWindowCount > 0 ? _rollupWindowCount : 1);
+    return JSON_OBJECT_SIZE(3) + JSON_ARRAY_SIZE(groups) +
+           groups * (JSON_OBJECT_SIZE(5) + 48) + // mais as cópias do sensorId e da unidade
+           (maxRecords + groups) * (JSON_ARRAY_SIZE(1) + JSON_ARRAY_SIZE(6)); // a página pode acabar um início depois
+}
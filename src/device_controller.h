@@ -9,6 +9,7 @@
 #include "sensors/VolumeSensor.h"
 #include "sensors/PressureSensor.h"
 #include <vector>
+#include "sensor_rollup.h"
 
 // #include "TemperatureSensor.h" // Adicione aqui os outros .h dos seus sensores
 
@@ -47,11 +48,74 @@ public:
     const std::vector<Sensor*>& getSensors() const;
     long getMinSamplingInterval();
 
+    /**
+     * @brief Executa as amostragens e notificações cujo prazo já venceu.
+     * Cada sensor tem dois prazos (amostragem e notificação) numa min-heap.
+     * @return Milissegundos até ao próximo prazo, para o loop() dormir até lá.
+     */
+    unsigned long runScheduler();
+
+    // --- AMOSTRAS RECENTES (buffer circular em RAM de cada sensor) ---
+    Sensor* findSensor(const String& sensorId) const;
+    size_t getRecentSamples(const String& sensorId, size_t lastN, SensorSample* out, size_t maxCount) const;
+    size_t getSamplesSince(const String& sensorId, time_t since, SensorSample* out, size_t maxCount) const;
+
+    /**
+     * @brief Acrescenta a 'array' um objeto por sensor:
+     * {"sensorId", "unit", "samples": [[ts, raw, value], ...]}, da amostra mais antiga para a mais recente.
+     * @param sensorId Sensor pedido; vazio = todos.
+     * @param lastN Últimas N amostras (0 = todas as guardadas). Ignorado se since != 0.
+     * @param since Só amostras com timestamp >= since (epoch).
+     * @return false se sensorId não existir.
+     */
+    bool recentSamplesToJson(JsonArray array, const String& sensorId, size_t lastN, time_t since) const;
+
+    // --- AGREGADOS (min, max, média, contagem e último por janela, atualizados a cada amostragem) ---
+
+    /**
+     * @brief Acrescenta a 'array' um objeto por sensor e janela:
+     * {"sensorId", "unit", "window", "rollups": [[início, contagem, min, max, média, último], ...]},
+     * dos ficheiros diários e da janela ainda aberta (então "partial": true e é o último).
+     * @param sensorId Sensor pedido; vazio = todos.
+     * @param windowSec Duração da janela em segundos; 0 = todas.
+     * @param since/until Início das janelas em [since, until] (0 = sem limite).
+     * @param maxRecords Máximo de agregados; os que sobram começam em 'next' (0 = não sobrou nada).
+     * @return false se sensorId não existir.
+     */
+    bool rollupsToJson(JsonArray array, const String& sensorId, uint32_t windowSec, time_t since, time_t until,
+                       size_t maxRecords, time_t& next) const;
+    // Capacidade do JsonDocument para rollupsToJson() com até maxRecords agregados
+    size_t rollupsJsonCapacity(size_t maxRecords) const;
+
 private:
+    enum class ScheduledAction : uint8_t {
+        SAMPLE,
+        NOTIFY
+    };
+
+    struct ScheduledTask {
+        unsigned long dueMillis;
+        Sensor* sensor;
+        ScheduledAction action;
+    };
+
+    void _startScheduler();
+    void _pushTask(const ScheduledTask& task);
+    void _updateRollups(Sensor* sensor);
+
+    std::vector<ScheduledTask> _schedule; // min-heap por dueMillis
+    bool _schedulerStarted;
+
     std::vector<Sensor*> _sensors;
     HubBleConfig _bleConfig;
     bool _isReady;
     long _realtimeNotifyIntervalMs;
+
+    // Janela aberta de cada sensor: _rollups[sensor * _rollupWindowCount + janela]
+    std::vector<RollupStats> _rollups;
+    size_t _rollupWindowCount;
+    uint32_t _rollupPruneDay; // dia (epoch / 86400) da última limpeza dos ficheiros antigos
+    mutable portMUX_TYPE _rollupMux = portMUX_INITIALIZER_UNLOCKED;
 };
 
 #endif // DEVICE_CONTROLLER_H
\ No newline at end of file
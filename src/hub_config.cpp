@@ -7,7 +7,11 @@ HubConfig& HubConfig::getInstance() {
     return instance;
 }
 
-HubConfig::HubConfig() : _isLoaded(false) {}
+HubConfig::HubConfig() : _isLoaded(false), _logFormat(LogFormat::JSONL), _logCompression(LogCompression::COLUMNAR) {
+    _logRetention = { 0, 0, 32768, 0, 3600 };
+    _bleSnapshot = { false, true, 1000 };
+    _rollup = { { 3600, 86400 }, 2, 366 };
+}
 
 bool HubConfig::load() {
     if (_isLoaded) return true;
@@ -34,7 +38,7 @@ bool HubConfig::load() {
     _jsonString = configFile.readString();
     configFile.close();
 
-    DynamicJsonDocument doc(512);
+    DynamicJsonDocument doc(1024);
     DeserializationError error = deserializeJson(doc, _jsonString);
 
     if (error) {
@@ -53,6 +57,46 @@ bool HubConfig::load() {
    // _main_tx_uuid = doc["ble"]["main_tx_characteristic_uuid"].as<String>();
     _service_uuid = doc["ble"]["service_uuid"].as<String>();
 
+    JsonObject snapshot = doc["ble"]["snapshot"];
+    _bleSnapshot.enabled = snapshot["enabled"] | false;
+    _bleSnapshot.perSensor = snapshot["per_sensor"] | true;
+    _bleSnapshot.intervalMs = snapshot["interval_ms"] | 1000UL;
+    if (!_bleSnapshot.enabled) _bleSnapshot.perSensor = true; // sem snapshot, só há as características por sensor
+
+    String logFormat = doc["log"]["format"] | "jsonl";
+    _logFormat = (logFormat == "binary") ? LogFormat::BINARY : LogFormat::JSONL;
+    // "columnar" (ou true), "gzip" ou false
+    JsonVariant compress = doc["log"]["compress"];
+    if (compress.is<bool>()) {
+        _logCompression = compress.as<bool>() ? LogCompression::COLUMNAR : LogCompression::NONE;
+    } else {
+        String mode = compress | "columnar";
+        _logCompression = (mode == "gzip") ? LogCompression::GZIP : LogCompression::COLUMNAR;
+    }
+
+    JsonObject retention = doc["retention"];
+    _logRetention.maxDays = retention["max_days"] | 0;
+    _logRetention.maxBytes = retention["max_bytes"] | 0UL;
+    _logRetention.minFreeBytes = retention["min_free_bytes"] | 32768UL;
+    _logRetention.aggregateAfterDays = retention["aggregate_after_days"] | 0;
+    _logRetention.aggregateIntervalSec = retention["aggregate_interval_sec"] | 3600UL;
+    if (_logRetention.aggregateIntervalSec < 60) _logRetention.aggregateIntervalSec = 60;
+
+    // Janelas que não dividem o dia atravessariam o ficheiro diário: ficam de fora
+    JsonObject rollup = doc["rollup"];
+    if (rollup["windows_sec"].is<JsonArray>()) {
+        _rollup.windowCount = 0;
+        for (JsonVariant value : rollup["windows_sec"].as<JsonArray>()) {
+            uint32_t window = value.as<uint32_t>();
+            if (window < 60 || 86400UL % window != 0 || _rollup.windowCount >= ROLLUP_MAX_WINDOWS) {
+                Serial.printf("⚠️ Janela de agregados ignorada: %lu s\n", (unsigned long)window);
+                continue;
+            }
+            _rollup.windowsSec[_rollup.windowCount++] = window;
+        }
+    }
+    _rollup.maxDays = rollup["max_days"] | 366;
+
     _isLoaded = true;
     Serial.println("HubConfig carregado com sucesso. ID do Hub: " + _details.id);
     return true;
@@ -69,3 +113,8 @@ String HubConfig::getConfigJsonString() const {
 String HubConfig::getRxCharacteristicUuid() const { return _rx_uuid; }
 String HubConfig::getMainTxCharacteristicUuid() const { return _main_tx_uuid; }
 String HubConfig::getServiceUuid() const { return _service_uuid; }
+LogFormat HubConfig::getLogFormat() const { return _logFormat; }
+LogCompression HubConfig::getLogCompression() const { return _logCompression; }
+const LogRetentionPolicy& HubConfig::getLogRetention() const { return _logRetention; }
+const BleSnapshotConfig& HubConfig::getBleSnapshot() const { return _bleSnapshot; }
+const RollupConfig& HubConfig::getRollup() const { return _rollup; }
@@ -2,6 +2,7 @@
 #define HUB_CONFIG_H
 
 #include <Arduino.h>
+#include "log_format.h"
 
 // Struct para organizar os dados lidos
 struct HubDetails {
@@ -11,6 +12,31 @@ struct HubDetails {
     float longitude;
 };
 
+// Política de retenção dos logs ("retention" em hub_config.json); 0 desliga cada limite
+struct LogRetentionPolicy {
+    uint16_t maxDays;            // dias guardados, contando com o de hoje
+    uint32_t maxBytes;           // soma dos ficheiros de log no flash
+    uint32_t minFreeBytes;       // espaço livre mínimo no LittleFS
+    uint16_t aggregateAfterDays; // dias com esta idade ficam só com médias por intervalo
+    uint32_t aggregateIntervalSec;
+};
+
+// Característica agregada com todos os sensores numa notificação ("ble.snapshot" em hub_config.json)
+struct BleSnapshotConfig {
+    bool enabled;
+    bool perSensor;      // mantém também uma característica por sensor (apps antigos)
+    uint32_t intervalMs; // intervalo mínimo entre snapshots
+};
+
+// Janelas dos agregados por sensor ("rollup" em hub_config.json)
+#define ROLLUP_MAX_WINDOWS 4
+
+struct RollupConfig {
+    uint32_t windowsSec[ROLLUP_MAX_WINDOWS]; // cada uma divide o dia (3600, 86400, ...)
+    uint8_t windowCount;
+    uint16_t maxDays; // ficheiros de agregados guardados; 0 = todos
+};
+
 class HubConfig {
 public:
     // Padrão Singleton para garantir uma única instância
@@ -29,6 +55,15 @@ public:
     String getMainTxCharacteristicUuid() const;
     String getServiceUuid() const;
 
+    // Formato dos ficheiros de log ("log.format": "jsonl" ou "binary")
+    LogFormat getLogFormat() const;
+    // Compactação dos dias fechados ("log.compress": "columnar" por omissão, "gzip" ou false)
+    LogCompression getLogCompression() const;
+    // Limites de idade e de espaço aplicados pelo loopDataLogger ("retention")
+    const LogRetentionPolicy& getLogRetention() const;
+    const BleSnapshotConfig& getBleSnapshot() const;
+    const RollupConfig& getRollup() const;
+
 private:
     HubConfig(); // Construtor privado
     HubConfig(const HubConfig&) = delete;
@@ -41,6 +76,11 @@ private:
     String _rx_uuid;
     String _main_tx_uuid;
     String _service_uuid;
+    LogFormat _logFormat;
+    LogCompression _logCompression;
+    LogRetentionPolicy _logRetention;
+    BleSnapshotConfig _bleSnapshot;
+    RollupConfig _rollup;
 };
 
 #endif // HUB_CONFIG_H
\ No newline at end of file
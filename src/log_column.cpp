@@ -0,0 +1,426 @@
+#include "log_column.h"
+#include <LittleFS.h>
+
+namespace {
+
+// Bits gravados do mais significativo para o menos significativo, colunas alinhadas ao byte
+struct ColumnBitWriter {
+    uint8_t* out;
+    size_t len;
+    uint64_t acc;
+    uint8_t count;
+
+    explicit ColumnBitWriter(uint8_t* o) : out(o), len(0), acc(0), count(0) {}
+
+    void put(uint32_t value, uint8_t bits) {
+        acc = (acc << bits) | (bits == 32 ? value : (value & ((1u << bits) - 1)));
+        count += bits;
+        while (count >= 8) {
+            count -= 8;
+            out[len++] = (uint8_t)(acc >> count);
+        }
+    }
+
+    size_t flush() {
+        if (count > 0) out[len++] = (uint8_t)(acc << (8 - count));
+        count = 0;
+        return len;
+    }
+};
+
+struct ColumnBitReader {
+    const uint8_t* in;
+    size_t len;
+    size_t pos;
+    uint64_t acc;
+    uint8_t count;
+    bool overrun;
+
+    ColumnBitReader(const uint8_t* i, size_t l) : in(i), len(l), pos(0), acc(0), count(0), overrun(false) {}
+
+    uint32_t get(uint8_t bits) {
+        while (count < bits) {
+            if (pos >= len) overrun = true;
+            acc = (acc << 8) | (pos < len ? in[pos] : 0);
+            pos++;
+            count += 8;
+        }
+        count -= bits;
+        uint32_t value = (uint32_t)(acc >> count);
+        return bits == 32 ? value : value & ((1u << bits) - 1);
+    }
+};
+
+uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+int64_t unzigzag(uint64_t z) {
+    return (int64_t)(z >> 1) ^ -(int64_t)(z & 1);
+}
+
+bool isValidColumnHeader(const LogFileHeader& header) {
+    return memcmp(header.magic, LOG_COL_MAGIC, sizeof(header.magic)) == 0 && header.version == LOG_COL_VERSION;
+}
+
+bool isValidBlockHeader(const LogColumnBlockHeader& block) {
+    return block.count > 0 && block.count <= LOG_COL_BLOCK_RECORDS &&
+           (size_t)block.tsBytes + block.rawBytes + block.valueBytes <= 2048;
+}
+
+} // namespace
+
+// --- LogColumnWriter ---
+
+LogColumnWriter::LogColumnWriter() : _out(nullptr), _ok(false), _records(0), _count(0) {}
+
+bool LogColumnWriter::begin(File& out, const LogFileHeader& header) {
+    _out = &out;
+    _records = 0;
+    _count = 0;
+
+    LogFileHeader colHeader = header;
+    memcpy(colHeader.magic, LOG_COL_MAGIC, sizeof(colHeader.magic));
+    colHeader.version = LOG_COL_VERSION;
+    colHeader.recordSize = LOG_COL_BLOCK_RECORDS;
+    _ok = out.write((const uint8_t*)&colHeader, sizeof(colHeader)) == sizeof(colHeader);
+    return _ok;
+}
+
+bool LogColumnWriter::add(uint32_t timestamp, int32_t raw, float value) {
+    if (!_ok) return false;
+    _ts[_count] = timestamp;
+    _raw[_count] = raw;
+    memcpy(&_value[_count], &value, sizeof(uint32_t));
+    _count++;
+    _records++;
+    if (_count == LOG_COL_BLOCK_RECORDS) return _writeBlock();
+    return true;
+}
+
+bool LogColumnWriter::finish() {
+    return _writeBlock();
+}
+
+uint32_t LogColumnWriter::recordCount() const {
+    return _records;
+}
+
+bool LogColumnWriter::_writeBlock() {
+    if (!_ok || _count == 0) return _ok;
+
+    LogColumnBlockHeader block = {};
+    block.count = _count;
+    block.firstTs = _ts[0];
+    block.lastTs = _ts[0];
+
+    // Timestamps: o primeiro vai no cabeçalho; depois a variação do intervalo entre leituras,
+    // que com amostragem regular é quase sempre 0 (1 bit). Saltos grandes gravam o timestamp inteiro.
+    ColumnBitWriter ts(_buf);
+    int64_t prevDelta = 0;
+    for (size_t i = 1; i < _count; i++) {
+        if (_ts[i] > block.lastTs) block.lastTs = _ts[i];
+        int64_t delta = (int64_t)_ts[i] - _ts[i - 1];
+        uint64_t z = zigzag(delta - prevDelta);
+        if (z == 0) {
+            ts.put(0, 1);
+        } else if (z < 128) {
+            ts.put(0b10, 2);
+            ts.put(z, 7);
+        } else if (z < 512) {
+            ts.put(0b110, 3);
+            ts.put(z, 9);
+        } else if (z < 4096) {
+            ts.put(0b1110, 4);
+            ts.put(z, 12);
+        } else {
+            ts.put(0b1111, 4);
+            ts.put(_ts[i], 32);
+        }
+        prevDelta = delta;
+    }
+    block.tsBytes = ts.flush();
+
+    // Raw: diferença para o anterior em zigzag + varint (1 byte enquanto variar menos de ±64)
+    uint8_t* raw = _buf + block.tsBytes;
+    size_t rawLen = 0;
+    int64_t prevRaw = 0;
+    for (size_t i = 0; i < _count; i++) {
+        uint64_t z = zigzag((int64_t)_raw[i] - prevRaw);
+        prevRaw = _raw[i];
+        do {
+            uint8_t b = z & 0x7F;
+            z >>= 7;
+            raw[rawLen++] = b | (z ? 0x80 : 0);
+        } while (z);
+    }
+    block.rawBytes = rawLen;
+
+    // Value: XOR com o float anterior; só os bits que mudaram, reaproveitando a janela anterior
+    ColumnBitWriter value(raw + rawLen);
+    value.put(_value[0], 32);
+    uint8_t prevLead = 0xFF;
+    uint8_t prevTrail = 0;
+    for (size_t i = 1; i < _count; i++) {
+        uint32_t x = _value[i] ^ _value[i - 1];
+        if (x == 0) {
+            value.put(0, 1);
+            continue;
+        }
+        uint8_t lead = __builtin_clz(x);
+        uint8_t trail = __builtin_ctz(x);
+        if (prevLead != 0xFF && lead >= prevLead && trail >= prevTrail) {
+            value.put(0b10, 2);
+            value.put(x >> prevTrail, 32 - prevLead - prevTrail);
+        } else {
+            uint8_t len = 32 - lead - trail;
+            value.put(0b11, 2);
+            value.put(lead, 5);
+            value.put(len - 1, 5);
+            value.put(x >> trail, len);
+            prevLead = lead;
+            prevTrail = trail;
+        }
+    }
+    block.valueBytes = value.flush();
+
+    size_t payload = (size_t)block.tsBytes + block.rawBytes + block.valueBytes;
+    block.crc = logCrc32(0, _buf, payload);
+    _ok = _out->write((const uint8_t*)&block, sizeof(block)) == sizeof(block) &&
+          _out->write(_buf, payload) == payload;
+    _count = 0;
+    return _ok;
+}
+
+// --- LogColumnReader ---
+
+LogColumnReader::LogColumnReader()
+    : _position(0), _blockStart(0), _blockLoaded(false), _decoded(false), _done(true), _index(0), _decodedCount(0) {
+    memset(&_header, 0, sizeof(_header));
+    memset(&_block, 0, sizeof(_block));
+}
+
+bool LogColumnReader::open(const String& path) {
+    close();
+    _file = LittleFS.open(path, "r");
+    if (!_file) return false;
+    if (_file.read((uint8_t*)&_header, sizeof(_header)) != sizeof(_header) || !isValidColumnHeader(_header)) {
+        Serial.printf("⚠️ Cabeçalho inválido em %s\n", path.c_str());
+        close();
+        return false;
+    }
+    _path = path;
+    return _restart();
+}
+
+void LogColumnReader::close() {
+    if (_file) _file.close();
+    _payload.clear();
+    _payload.shrink_to_fit();
+    _done = true;
+}
+
+bool LogColumnReader::isOpen() const {
+    return (bool)_file;
+}
+
+const LogFileHeader& LogColumnReader::header() const {
+    return _header;
+}
+
+bool LogColumnReader::_restart() {
+    _position = 0;
+    _blockStart = 0;
+    _blockLoaded = false;
+    _decoded = false;
+    _done = false;
+    _index = 0;
+    _decodedCount = 0;
+    return _file.seek(sizeof(LogFileHeader));
+}
+
+bool LogColumnReader::_readBlockHeader() {
+    if (_done) return false;
+    if (_file.read((uint8_t*)&_block, sizeof(_block)) != sizeof(_block) || !isValidBlockHeader(_block)) {
+        _done = true; // fim do ficheiro (ou bloco final cortado)
+        return false;
+    }
+    _blockLoaded = true;
+    _decoded = false;
+    _index = 0;
+    _decodedCount = 0;
+    return true;
+}
+
+// Passa ao bloco seguinte sem ler as colunas do atual
+void LogColumnReader::_skipBlock() {
+    if (!_decoded) {
+        size_t payload = (size_t)_block.tsBytes + _block.rawBytes + _block.valueBytes;
+        if (!_file.seek(_file.position() + payload)) _done = true;
+    }
+    _blockStart += _block.count;
+    _position = _blockStart;
+    _blockLoaded = false;
+}
+
+bool LogColumnReader::_decodeBlock() {
+    _decoded = true;
+    _decodedCount = 0;
+
+    size_t payload = (size_t)_block.tsBytes + _block.rawBytes + _block.valueBytes;
+    _payload.resize(payload);
+    if (_file.read(_payload.data(), payload) != payload) {
+        _done = true;
+        return false;
+    }
+    if (logCrc32(0, _payload.data(), payload) != _block.crc) {
+        Serial.printf("⚠️ Bloco corrompido em %s (registo %u), ignorado\n", _path.c_str(), (unsigned)_blockStart);
+        return false;
+    }
+
+    ColumnBitReader ts(_payload.data(), _block.tsBytes);
+    _ts[0] = _block.firstTs;
+    int64_t prevDelta = 0;
+    for (size_t i = 1; i < _block.count; i++) {
+        int64_t delta;
+        if (ts.get(1) == 0) {
+            delta = prevDelta;
+        } else if (ts.get(1) == 0) {
+            delta = prevDelta + unzigzag(ts.get(7));
+        } else if (ts.get(1) == 0) {
+            delta = prevDelta + unzigzag(ts.get(9));
+        } else if (ts.get(1) == 0) {
+            delta = prevDelta + unzigzag(ts.get(12));
+        } else {
+            delta = (int64_t)ts.get(32) - _ts[i - 1];
+        }
+        _ts[i] = (uint32_t)(_ts[i - 1] + delta);
+        prevDelta = delta;
+    }
+
+    const uint8_t* raw = _payload.data() + _block.tsBytes;
+    size_t rawPos = 0;
+    int64_t prevRaw = 0;
+    for (size_t i = 0; i < _block.count; i++) {
+        uint64_t z = 0;
+        uint8_t shift = 0;
+        uint8_t b;
+        do {
+            if (rawPos >= _block.rawBytes || shift > 63) return false;
+            b = raw[rawPos++];
+            z |= (uint64_t)(b & 0x7F) << shift;
+            shift += 7;
+        } while (b & 0x80);
+        prevRaw += unzigzag(z);
+        _raw[i] = (int32_t)prevRaw;
+    }
+
+    ColumnBitReader value(raw + _block.rawBytes, _block.valueBytes);
+    _value[0] = value.get(32);
+    uint8_t lead = 0;
+    uint8_t trail = 0;
+    for (size_t i = 1; i < _block.count; i++) {
+        uint32_t x = 0;
+        if (value.get(1) == 1) {
+            if (value.get(1) == 1) {
+                lead = value.get(5);
+                uint8_t len = value.get(5) + 1;
+                if (lead + len > 32) return false;
+                trail = 32 - lead - len;
+            }
+            uint8_t len = 32 - lead - trail;
+            x = value.get(len) << trail;
+        }
+        _value[i] = _value[i - 1] ^ x;
+    }
+
+    if (ts.overrun || value.overrun) return false;
+    _decodedCount = _block.count;
+    return true;
+}
+
+bool LogColumnReader::next(LogRecord& record) {
+    while (isOpen()) {
+        if (!_blockLoaded && !_readBlockHeader()) return false;
+        if (!_decoded) _decodeBlock();
+        if (_index < _decodedCount) {
+            record.timestamp = _ts[_index];
+            record.sensorIndex = 0;
+            record.raw = _raw[_index];
+            memcpy(&record.value, &_value[_index], sizeof(float));
+            record.crc = 0;
+            _index++;
+            _position++;
+            return true;
+        }
+        // Fim do bloco (ou bloco corrompido): as colunas já foram lidas por inteiro
+        _blockStart += _block.count;
+        _position = _blockStart;
+        _blockLoaded = false;
+    }
+    return false;
+}
+
+void LogColumnReader::skipBefore(time_t since) {
+    while (isOpen()) {
+        if (!_blockLoaded && !_readBlockHeader()) return;
+        if ((time_t)_block.lastTs >= since) return;
+        _skipBlock();
+    }
+}
+
+size_t LogColumnReader::position() const {
+    return _position;
+}
+
+bool LogColumnReader::seek(size_t record) {
+    if (!isOpen()) return false;
+    if (record < _blockStart) _restart();
+
+    while (true) {
+        if (!_blockLoaded && !_readBlockHeader()) return record == _position;
+        if (record < _blockStart + _block.count) {
+            if (!_decoded) _decodeBlock();
+            _index = record - _blockStart;
+            _position = record;
+            return true;
+        }
+        _skipBlock();
+    }
+}
+
+size_t LogColumnReader::recordCount() {
+    size_t total = 0;
+    File f = LittleFS.open(_path, "r");
+    if (!f || !f.seek(sizeof(LogFileHeader))) return 0;
+    LogColumnBlockHeader block;
+    while (f.read((uint8_t*)&block, sizeof(block)) == sizeof(block) && isValidBlockHeader(block)) {
+        total += block.count;
+        if (!f.seek(f.position() + block.tsBytes + block.rawBytes + block.valueBytes)) break;
+    }
+    f.close();
+    return total;
+}
+
+bool LogColumnReader::timeBounds(uint32_t& first, uint32_t& last) {
+    first = 0;
+    last = 0;
+    File f = LittleFS.open(_path, "r");
+    if (!f || !f.seek(sizeof(LogFileHeader))) return false;
+    LogColumnBlockHeader block;
+    while (f.read((uint8_t*)&block, sizeof(block)) == sizeof(block) && isValidBlockHeader(block)) {
+        if (first == 0) first = block.firstTs;
+        last = block.lastTs;
+        if (!f.seek(f.position() + block.tsBytes + block.rawBytes + block.valueBytes)) break;
+    }
+    f.close();
+    return first != 0;
+}
+
+size_t LogColumnReader::fileSize() {
+    return _file ? _file.size() : 0;
+}
+
+time_t LogColumnReader::lastWrite() {
+    return _file ? _file.getLastWrite() : 0;
+}
@@ -0,0 +1,104 @@
+#ifndef LOG_COLUMN_H
+#define LOG_COLUMN_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <vector>
+#include "log_format.h"
+
+// Registos por bloco: o leitor só decodifica um bloco de cada vez
+#define LOG_COL_BLOCK_RECORDS 128
+
+/**
+ * @brief Cabeçalho de cada bloco de um ficheiro .col, seguido das três colunas:
+ * timestamps (delta-of-delta em bits), raw (delta zigzag em varint) e value (XOR dos floats, como no Gorilla).
+ * firstTs/lastTs deixam saltar blocos inteiros fora de um intervalo sem os decodificar.
+ */
+struct __attribute__((packed)) LogColumnBlockHeader {
+    uint16_t count;
+    uint16_t tsBytes;
+    uint16_t rawBytes;
+    uint16_t valueBytes;
+    uint32_t firstTs;
+    uint32_t lastTs;
+    uint32_t crc; // CRC-32 das três colunas
+};
+
+/**
+ * @brief Codificador em colunas dos dias fechados. Os registos ficam em RAM até completar um bloco
+ * de LOG_COL_BLOCK_RECORDS; com leituras a intervalos fixos e valores que mudam devagar, cada
+ * registo ocupa 3 a 4 bytes (contra 14 no .bin e ~110 no JSONL).
+ */
+class LogColumnWriter {
+public:
+    LogColumnWriter();
+
+    bool begin(File& out, const LogFileHeader& header); // grava o cabeçalho (magic LOG_COL_MAGIC)
+    bool add(uint32_t timestamp, int32_t raw, float value);
+    bool finish(); // grava o último bloco incompleto
+
+    uint32_t recordCount() const;
+
+private:
+    bool _writeBlock();
+
+    File* _out;
+    bool _ok;
+    uint32_t _records;
+    size_t _count;
+    uint32_t _ts[LOG_COL_BLOCK_RECORDS];
+    int32_t _raw[LOG_COL_BLOCK_RECORDS];
+    uint32_t _value[LOG_COL_BLOCK_RECORDS]; // bits do float
+    uint8_t _buf[2048];                     // colunas de um bloco no pior caso
+};
+
+/**
+ * @brief Leitor sequencial de um ficheiro .col. Posições contam registos (não bytes);
+ * seek para trás recomeça do primeiro bloco, mas salta blocos inteiros só pelo cabeçalho.
+ */
+class LogColumnReader {
+public:
+    LogColumnReader();
+
+    bool open(const String& path);
+    void close();
+    bool isOpen() const;
+
+    const LogFileHeader& header() const; // metadados do sensor (sensorId, tipo, unidade)
+
+    bool next(LogRecord& record); // próximo registo (timestamp, raw e value); false no fim
+    void skipBefore(time_t since); // salta os blocos que acabam antes de 'since'
+
+    size_t position() const;
+    bool seek(size_t record);
+    size_t recordCount();                       // soma das contagens dos blocos
+    bool timeBounds(uint32_t& first, uint32_t& last); // primeiro e último timestamp do ficheiro
+    size_t fileSize();
+    time_t lastWrite();
+
+private:
+    bool _restart();
+    bool _readBlockHeader();
+    void _skipBlock();
+    bool _decodeBlock();
+
+    File _file;
+    String _path;
+    LogFileHeader _header;
+    size_t _position;   // registos já entregues
+    size_t _blockStart; // posição do primeiro registo do bloco atual
+
+    LogColumnBlockHeader _block;
+    bool _blockLoaded;  // cabeçalho do bloco atual lido
+    bool _decoded;      // colunas do bloco atual decodificadas
+    bool _done;
+    size_t _index;      // próximo registo dentro do bloco
+    size_t _decodedCount; // registos válidos do bloco (0 se o CRC falhou)
+
+    uint32_t _ts[LOG_COL_BLOCK_RECORDS];
+    int32_t _raw[LOG_COL_BLOCK_RECORDS];
+    uint32_t _value[LOG_COL_BLOCK_RECORDS];
+    std::vector<uint8_t> _payload;
+};
+
+#endif
@@ -0,0 +1,384 @@
+#include "log_format.h"
+#include "log_column.h"
+#include <LittleFS.h>
+#include <atomic>
+
+static std::atomic<int> _filesInUse(0);
+
+// CRC-8 (polinómio 0x07), suficiente para detetar registos corrompidos por escrita interrompida
+uint8_t logCrc8(const uint8_t* data, size_t len) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+void initLogFileHeader(LogFileHeader& header, const String& sensorId, const String& sensorType, const String& unit) {
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LOG_BIN_MAGIC, sizeof(header.magic));
+    header.version = LOG_BIN_VERSION;
+    header.recordSize = sizeof(LogRecord);
+    strncpy(header.sensorId, sensorId.c_str(), sizeof(header.sensorId));
+    strncpy(header.sensorType, sensorType.c_str(), sizeof(header.sensorType));
+    strncpy(header.unit, unit.c_str(), sizeof(header.unit));
+}
+
+bool isValidLogFileHeader(const LogFileHeader& header) {
+    return memcmp(header.magic, LOG_BIN_MAGIC, sizeof(header.magic)) == 0 &&
+           header.version == LOG_BIN_VERSION &&
+           header.recordSize == sizeof(LogRecord);
+}
+
+void encodeLogRecord(LogRecord& record, time_t timestamp, uint8_t sensorIndex, int rawValue, float calibratedValue) {
+    record.timestamp = (uint32_t)timestamp;
+    record.sensorIndex = sensorIndex;
+    record.raw = rawValue;
+    record.value = calibratedValue;
+    record.crc = logCrc8((const uint8_t*)&record, sizeof(record) - 1);
+}
+
+bool isValidLogRecord(const LogRecord& record) {
+    return logCrc8((const uint8_t*)&record, sizeof(record) - 1) == record.crc;
+}
+
+size_t formatLogRecordJson(const LogFileHeader& header, const LogRecord& record, char* out, size_t outLen) {
+    time_t ts = record.timestamp;
+    struct tm timeinfo;
+    localtime_r(&ts, &timeinfo);
+
+    char isoTimestamp[21];
+    strftime(isoTimestamp, sizeof(isoTimestamp), "%Y-%m-%dT%H:%M:%SZ", &timeinfo);
+
+    // Mesmos campos e ordem que o logSensorReading grava em JSONL
+    int len = snprintf(out, outLen,
+        "{\"ts\":\"%s\",\"sensorId\":\"%.*s\",\"sensorType\":\"%.*s\",\"raw\":%d,\"value\":%.2f,\"unit\":\"%.*s\"}",
+        isoTimestamp,
+        (int)strnlen(header.sensorId, sizeof(header.sensorId)), header.sensorId,
+        (int)strnlen(header.sensorType, sizeof(header.sensorType)), header.sensorType,
+        (int)record.raw,
+        record.value,
+        (int)strnlen(header.unit, sizeof(header.unit)), header.unit);
+
+    if (len < 0 || (size_t)len >= outLen) return 0;
+    return len;
+}
+
+bool isLogFileName(const String& name) {
+    String plain = logUncompressedName(name);
+    return plain.endsWith(LOG_JSONL_EXT) || plain.endsWith(LOG_BIN_EXT);
+}
+
+bool isCompressedLogFileName(const String& name) {
+    return logCompressionOf(name) != LogCompression::NONE && isLogFileName(name);
+}
+
+bool isColumnarLogFileName(const String& name) {
+    return logCompressionOf(name) == LogCompression::COLUMNAR && isLogFileName(name);
+}
+
+String logUncompressedName(const String& name) {
+    LogCompression compression = logCompressionOf(name);
+    if (compression == LogCompression::NONE) return name;
+    return name.substring(0, name.length() - strlen(logCompressionExt(compression)));
+}
+
+LogCompression logCompressionOf(const String& name) {
+    if (name.endsWith(LOG_GZIP_EXT)) return LogCompression::GZIP;
+    if (name.endsWith(LOG_COL_EXT)) return LogCompression::COLUMNAR;
+    return LogCompression::NONE;
+}
+
+const char* logCompressionExt(LogCompression compression) {
+    switch (compression) {
+        case LogCompression::GZIP: return LOG_GZIP_EXT;
+        case LogCompression::COLUMNAR: return LOG_COL_EXT;
+        default: return "";
+    }
+}
+
+String resolveLogFilePath(const String& path) {
+    if (logCompressionOf(path) != LogCompression::NONE || LittleFS.exists(path)) return path;
+    if (LittleFS.exists(path + LOG_COL_EXT)) return path + LOG_COL_EXT;
+    if (LittleFS.exists(path + LOG_GZIP_EXT)) return path + LOG_GZIP_EXT;
+    return path;
+}
+
+String logIndexPathFor(const String& logFilePath) {
+    int dot = logFilePath.lastIndexOf('.');
+    return (dot != -1 ? logFilePath.substring(0, dot) : logFilePath) + LOG_INDEX_EXT;
+}
+
+time_t parseLogTimestamp(const char* line) {
+    const char* ts = strstr(line, "\"ts\":\"");
+    if (!ts) return 0;
+
+    struct tm timeinfo = {};
+    if (sscanf(ts + 6, "%d-%d-%dT%d:%d:%d", &timeinfo.tm_year, &timeinfo.tm_mon, &timeinfo.tm_mday,
+               &timeinfo.tm_hour, &timeinfo.tm_min, &timeinfo.tm_sec) != 6) {
+        return 0;
+    }
+    timeinfo.tm_year -= 1900;
+    timeinfo.tm_mon -= 1;
+    return mktime(&timeinfo); // inverso do localtime_r usado na gravação
+}
+
+bool getLogDayBounds(const String& dayDirName, time_t& dayStart, time_t& dayEnd) {
+    struct tm timeinfo = {};
+    if (sscanf(dayDirName.c_str(), "%d_%d_%d", &timeinfo.tm_year, &timeinfo.tm_mon, &timeinfo.tm_mday) != 3) {
+        return false;
+    }
+    timeinfo.tm_year -= 1900;
+    timeinfo.tm_mon -= 1;
+    dayStart = mktime(&timeinfo);
+    dayEnd = dayStart + 86399;
+    return true;
+}
+
+bool isLogDayInRange(const String& dayDirName, time_t since, time_t until) {
+    if (since == 0 && until == 0) return true;
+
+    time_t dayStart, dayEnd;
+    if (!getLogDayBounds(dayDirName, dayStart, dayEnd)) return true; // nome inesperado: não descarta
+
+    if (since != 0 && dayEnd < since) return false;
+    if (until != 0 && dayStart > until) return false;
+    return true;
+}
+
+LogFileUse::LogFileUse() {
+    _filesInUse++;
+}
+
+LogFileUse::~LogFileUse() {
+    _filesInUse--;
+}
+
+int logFilesInUse() {
+    return _filesInUse;
+}
+
+// --- LogFileReader ---
+
+LogFileReader::LogFileReader() : _binary(false), _since(0), _until(0) {
+    memset(&_header, 0, sizeof(_header));
+}
+
+LogFileReader::~LogFileReader() {
+    close();
+}
+
+bool LogFileReader::open(const String& filePath) {
+    close();
+    _since = 0;
+    _until = 0;
+
+    String path = resolveLogFilePath(filePath);
+    LogCompression compression = logCompressionOf(path);
+
+    if (compression == LogCompression::GZIP) {
+        _gzip.reset(new LogGzipReader());
+        if (!_gzip->open(path)) {
+            _gzip.reset();
+            return false;
+        }
+    } else if (compression == LogCompression::COLUMNAR) {
+        _columns.reset(new LogColumnReader());
+        if (!_columns->open(path)) {
+            _columns.reset();
+            return false;
+        }
+        _header = _columns->header(); // metadados para formatar as linhas JSON
+    } else {
+        _file = LittleFS.open(path, "r");
+        if (!_file) return false;
+    }
+    _filesInUse++;
+    _path = path;
+
+    _binary = logUncompressedName(path).endsWith(LOG_BIN_EXT);
+    if (_binary && !_columns) {
+        if (_readBytes((uint8_t*)&_header, sizeof(_header)) != sizeof(_header) || !isValidLogFileHeader(_header)) {
+            Serial.printf("⚠️ Cabeçalho inválido em %s\n", path.c_str());
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void LogFileReader::close() {
+    if (isOpen()) _filesInUse--;
+    if (_file) _file.close();
+    _gzip.reset();
+    _columns.reset();
+}
+
+bool LogFileReader::isOpen() const {
+    if (_columns) return _columns->isOpen();
+    return _gzip ? _gzip->isOpen() : (bool)_file;
+}
+
+bool LogFileReader::isBinary() const {
+    return _binary;
+}
+
+bool LogFileReader::isCompressed() const {
+    return _gzip || _columns;
+}
+
+void LogFileReader::setTimeRange(time_t since, time_t until) {
+    _since = since;
+    _until = until;
+    if (isOpen() && _since != 0) _seekToTimestamp(_since);
+}
+
+// Busca binária no índice pela última entrada anterior a 'since'
+void LogFileReader::_seekToTimestamp(time_t since) {
+    if (_columns) {
+        _columns->skipBefore(since); // cada bloco guarda o seu intervalo de timestamps
+        return;
+    }
+    if (_gzip) return; // a compactação apaga o .idx: o dia fechado é lido desde o início
+    File idx = LittleFS.open(logIndexPathFor(_path), "r");
+    if (!idx) return; // sem índice: lê desde o início
+
+    size_t dataStart = _binary ? sizeof(LogFileHeader) : 0;
+    size_t fileSize = _file.size();
+    size_t target = dataStart;
+
+    size_t lo = 0;
+    size_t hi = idx.size() / sizeof(LogIndexEntry);
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        LogIndexEntry entry;
+        idx.seek(mid * sizeof(LogIndexEntry));
+        if (idx.read((uint8_t*)&entry, sizeof(entry)) != sizeof(entry)) break;
+
+        if ((time_t)entry.timestamp < since) {
+            // Entradas além do fim do ficheiro (dados perdidos antes do flush) são ignoradas
+            if (entry.offset >= dataStart && entry.offset < fileSize) target = entry.offset;
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    idx.close();
+
+    if (target > dataStart) _file.seek(target);
+}
+
+size_t LogFileReader::_readRecordLine(char* out, size_t outLen, time_t& timestamp) {
+    if (_columns) {
+        LogRecord record;
+        while (_columns->next(record)) {
+            timestamp = record.timestamp;
+            if (_since != 0 && timestamp < _since) continue;
+            if (_until != 0 && timestamp > _until) return 0;
+            size_t len = formatLogRecordJson(_header, record, out, outLen);
+            if (len > 0) return len;
+        }
+        return 0;
+    }
+
+    if (_binary) {
+        LogRecord record;
+        while (_readBytes((uint8_t*)&record, sizeof(record)) == sizeof(record)) {
+            if (!isValidLogRecord(record)) continue; // registo corrompido, ignora
+            timestamp = record.timestamp;
+            // Fora do intervalo não vale a pena formatar
+            if (_since != 0 && timestamp < _since) continue;
+            if (_until != 0 && timestamp > _until) return 0;
+            size_t len = formatLogRecordJson(_header, record, out, outLen);
+            if (len > 0) return len;
+        }
+        return 0;
+    }
+
+    while (_available()) {
+        size_t len = 0;
+        bool overflow = false;
+        int c;
+        while ((c = _readByte()) >= 0 && c != '\n') {
+            if (len + 1 < outLen) out[len++] = (char)c;
+            else overflow = true;
+        }
+        while (len > 0 && (out[len - 1] == '\r' || out[len - 1] == ' ')) len--;
+        out[len] = '\0';
+
+        // Mesmo critério do código original: linhas com 2 caracteres ou menos não são registos
+        if (overflow || len <= 2) continue;
+
+        if (_since != 0 || _until != 0) {
+            timestamp = parseLogTimestamp(out);
+            if (_since != 0 && timestamp < _since) continue;
+            if (_until != 0 && timestamp > _until) return 0;
+        }
+        return len;
+    }
+    return 0;
+}
+
+size_t LogFileReader::readNextLine(char* out, size_t outLen) {
+    if (!isOpen()) return 0;
+    time_t timestamp = 0;
+    size_t len = _readRecordLine(out, outLen, timestamp);
+    // Passou de 'until': os registos seguintes do ficheiro também estão fora do intervalo
+    if (len == 0 && _until != 0) _seekToEnd();
+    return len;
+}
+
+// No .col, seek() conta registos e size() são bytes no flash: o fim é a contagem de registos
+void LogFileReader::_seekToEnd() {
+    if (_columns) _columns->seek(_columns->recordCount());
+    else seek(size());
+}
+
+String LogFileReader::readNextLine() {
+    char line[LOG_LINE_MAX];
+    size_t len = readNextLine(line, sizeof(line));
+    return len > 0 ? String(line) : String();
+}
+
+size_t LogFileReader::position() {
+    if (_columns) return _columns->position();
+    if (_gzip) return _gzip->position();
+    return _file ? _file.position() : 0;
+}
+
+bool LogFileReader::seek(size_t pos) {
+    if (_columns) return _columns->seek(pos);
+    if (_gzip) return _gzip->seek(pos);
+    return _file && _file.seek(pos);
+}
+
+size_t LogFileReader::size() {
+    if (_columns) return _columns->fileSize();
+    if (_gzip) return _gzip->size();
+    return _file ? _file.size() : 0;
+}
+
+time_t LogFileReader::lastWrite() {
+    if (_columns) return _columns->lastWrite();
+    if (_gzip) return _gzip->lastWrite();
+    return _file ? _file.getLastWrite() : 0;
+}
+
+size_t LogFileReader::_readBytes(uint8_t* buf, size_t len) {
+    return _gzip ? _gzip->read(buf, len) : _file.read(buf, len);
+}
+
+int LogFileReader::_readByte() {
+    return _gzip ? _gzip->read() : _file.read();
+}
+
+size_t LogFileReader::_available() {
+    return _gzip ? _gzip->available() : _file.available();
+}
+
+const LogFileHeader& LogFileReader::header() const {
+    return _header;
+}
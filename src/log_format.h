@@ -0,0 +1,184 @@
+#ifndef LOG_FORMAT_H
+#define LOG_FORMAT_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <memory>
+#include "log_gzip.h"
+
+// Extensões dos ficheiros de log diários
+#define LOG_JSONL_EXT ".jsonl"
+#define LOG_BIN_EXT ".bin"
+#define LOG_INDEX_EXT ".idx"
+#define LOG_GZIP_EXT ".gz" // sufixo dos ficheiros de dias fechados já compactados (<sensor>.jsonl.gz)
+#define LOG_COL_EXT ".col" // idem, codificados em colunas (<sensor>.jsonl.col)
+
+// Índice esparso: uma entrada a cada LOG_INDEX_INTERVAL registos de cada ficheiro
+#define LOG_INDEX_INTERVAL 32
+
+// Cabeçalho dos ficheiros binários
+#define LOG_BIN_MAGIC "PADL"
+#define LOG_BIN_VERSION 1
+
+// Cabeçalho dos ficheiros em colunas (mesma estrutura, outro magic)
+#define LOG_COL_MAGIC "PADC"
+#define LOG_COL_VERSION 1
+
+// Tamanho máximo de uma linha JSON (registo decodificado)
+#define LOG_LINE_MAX 192
+
+// Formato de gravação dos logs, escolhido por hub em hub_config.json ("log.format")
+enum class LogFormat : uint8_t {
+    JSONL = 0,
+    BINARY = 1
+};
+
+// Compactação dos dias fechados ("log.compress" em hub_config.json)
+enum class LogCompression : uint8_t {
+    NONE = 0,
+    GZIP = 1,     // <ficheiro>.gz, servido tal como está com Content-Encoding: gzip
+    COLUMNAR = 2  // <ficheiro>.col, ver log_column.h
+};
+
+/**
+ * @brief Cabeçalho gravado uma única vez no início de cada ficheiro .bin (e .col).
+ * Guarda os metadados que no JSONL se repetem em todas as linhas.
+ */
+struct __attribute__((packed)) LogFileHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t recordSize;
+    uint16_t reserved;
+    char sensorId[32];
+    char sensorType[24];
+    char unit[12];
+};
+
+/**
+ * @brief Registo binário de largura fixa (14 bytes contra ~110 bytes em JSON).
+ * O CRC-8 cobre todos os bytes anteriores do registo.
+ */
+struct __attribute__((packed)) LogRecord {
+    uint32_t timestamp;   // epoch em segundos
+    uint8_t sensorIndex;  // índice do sensor no hub
+    int32_t raw;
+    float value;
+    uint8_t crc;
+};
+
+/**
+ * @brief Entrada do índice temporal (<sensorId>.idx, ao lado do ficheiro de log).
+ * Aponta para o byte onde começa o registo com este timestamp.
+ */
+struct __attribute__((packed)) LogIndexEntry {
+    uint32_t timestamp;
+    uint32_t offset;
+};
+
+uint8_t logCrc8(const uint8_t* data, size_t len);
+
+void initLogFileHeader(LogFileHeader& header, const String& sensorId, const String& sensorType, const String& unit);
+bool isValidLogFileHeader(const LogFileHeader& header);
+
+void encodeLogRecord(LogRecord& record, time_t timestamp, uint8_t sensorIndex, int rawValue, float calibratedValue);
+bool isValidLogRecord(const LogRecord& record);
+
+/**
+ * @brief Escreve o registo como linha JSON (sem '\n'), idêntica à do formato JSONL.
+ * @return Número de bytes escritos em 'out' (0 se não couber).
+ */
+size_t formatLogRecordJson(const LogFileHeader& header, const LogRecord& record, char* out, size_t outLen);
+
+bool isLogFileName(const String& name); // .jsonl ou .bin, comprimidos ou não
+bool isCompressedLogFileName(const String& name); // .gz ou .col
+bool isColumnarLogFileName(const String& name);
+String logUncompressedName(const String& name); // nome sem o LOG_GZIP_EXT/LOG_COL_EXT
+LogCompression logCompressionOf(const String& name);
+const char* logCompressionExt(LogCompression compression); // "" para NONE
+
+// Caminho listado antes da compactação do dia: devolve o <caminho>.gz ou .col que o substituiu
+String resolveLogFilePath(const String& path);
+String logIndexPathFor(const String& logFilePath);
+
+// Extrai o campo "ts" (ISO 8601) de uma linha JSONL; 0 se não existir
+time_t parseLogTimestamp(const char* line);
+
+// Início e fim (epoch) do dia de um diretório diário AAAA_MM_DD
+bool getLogDayBounds(const String& dayDirName, time_t& dayStart, time_t& dayEnd);
+
+// Verifica se o diretório diário (AAAA_MM_DD) tem alguma parte dentro de [since, until] (0 = sem limite)
+bool isLogDayInRange(const String& dayDirName, time_t since, time_t until);
+
+/**
+ * @brief Marca uma leitura de ficheiro de log em curso enquanto existir. A compactação só troca
+ * um ficheiro pelo .gz/.col quando não há nenhuma (o LogFileReader marca as suas; downloads em bruto também).
+ */
+class LogFileUse {
+public:
+    LogFileUse();
+    ~LogFileUse();
+    LogFileUse(const LogFileUse&) = delete;
+    void operator=(const LogFileUse&) = delete;
+};
+
+int logFilesInUse();
+
+class LogColumnReader;
+
+/**
+ * @brief Leitor sequencial de um ficheiro de log, independente do formato.
+ * Ficheiros .bin são decodificados para a mesma linha JSON do formato JSONL,
+ * de modo que BLE e HTTP só convertem para JSON na borda. Ficheiros .gz são descomprimidos
+ * durante a leitura; position(), seek() e size() referem-se sempre aos bytes descomprimidos.
+ * Em ficheiros .col position() e seek() contam registos e size() é o tamanho no flash.
+ */
+class LogFileReader {
+public:
+    LogFileReader();
+    ~LogFileReader();
+
+    bool open(const String& filePath);
+    void close();
+
+    /**
+     * @brief Limita a leitura a [since, until] (0 = sem limite). Usa o índice .idx
+     * para saltar direto para o primeiro registo candidato em vez de ler desde o byte zero.
+     */
+    void setTimeRange(time_t since, time_t until);
+    bool isOpen() const;
+    bool isBinary() const;
+    bool isCompressed() const; // .gz ou .col
+
+    /**
+     * @brief Lê o próximo registo válido como linha JSON (sem '\n').
+     * @return Comprimento da linha, ou 0 no fim do ficheiro.
+     */
+    size_t readNextLine(char* out, size_t outLen);
+    String readNextLine();
+
+    size_t position();
+    bool seek(size_t pos);
+    size_t size();
+    time_t lastWrite(); // data da última escrita do ficheiro (para ETags)
+
+    const LogFileHeader& header() const;
+
+private:
+    size_t _readRecordLine(char* out, size_t outLen, time_t& timestamp);
+    void _seekToTimestamp(time_t since);
+    void _seekToEnd();
+    size_t _readBytes(uint8_t* buf, size_t len);
+    int _readByte();
+    size_t _available();
+
+    File _file;
+    std::unique_ptr<LogGzipReader> _gzip; // só existe para ficheiros .gz (janela de 4 KB)
+    std::unique_ptr<LogColumnReader> _columns; // só existe para ficheiros .col (um bloco decodificado)
+    String _path;
+    bool _binary;
+    LogFileHeader _header;
+    time_t _since;
+    time_t _until;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#include "log_generator.h"
+#include "data_logger.h"
+
+uint32_t generateTestLogs(const std::vector<TestLogSensor>& sensors, time_t startTs, uint32_t cycles, uint32_t stepSeconds) {
+  time_t current_ts = startTs;
+  uint32_t generated = 0;
+  // Progresso a cada 10% para não inundar o Serial em gerações grandes
+  uint32_t progressStep = cycles > 10 ? cycles / 10 : 1;
+
+  for (uint32_t i = 0; i < cycles; i++) {
+    // Loop secundário: para cada sensor na lista
+    for (const TestLogSensor& s : sensors) {
+      // Simula uma leitura de sensor
+      int raw = random(1000, 3000);
+      float value = s.sensor ? s.sensor->getValue(raw) : raw / 100.0f;
+
+      // Chama a nossa função de log com o timestamp controlado
+      logSensorReading(current_ts, s.sensorId, s.sensorType, s.unit, raw, value);
+      generated++;
+
+      // Incrementa o tempo para o próximo registo
+      current_ts += stepSeconds;
+    }
+    if ((i + 1) % progressStep == 0 || i + 1 == cycles) {
+      Serial.printf("Ciclo de geração %lu/%lu completo.\n", (unsigned long)(i + 1), (unsigned long)cycles);
+    }
+    yield();
+  }
+  return generated;
+}
+
+void generateTestLogs(DeviceController& device) {
+  Serial.println("\n=========================================");
+  Serial.println("INICIANDO GERAÇÃO DE LOGS DE TESTE...");
+  Serial.println("=========================================");
+
+  // Pega na lista de sensores que o DeviceController criou
+  const auto& sensors = device.getSensors();
+  if (sensors.empty()) {
+    Serial.println("Nenhum sensor configurado. Teste abortado.");
+    return;
+  }
+
+  std::vector<TestLogSensor> testSensors;
+  for (auto sensor : sensors) {
+    if (sensor) testSensors.push_back({sensor->getSensorId(), sensor->getSensorType(), sensor->getUnit(), sensor});
+  }
+  generateTestLogs(testSensors, TEST_LOG_START_TS, 10, 5);
+
+  Serial.println("=========================================");
+  Serial.println("GERAÇÃO DE LOGS DE TESTE CONCLUÍDA.");
+  Serial.println("Pode reiniciar o dispositivo ou iniciar a sincronização.");
+  Serial.println("=========================================");
+}
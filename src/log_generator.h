@@ -0,0 +1,32 @@
+#ifndef LOG_GENERATOR_H
+#define LOG_GENERATOR_H
+
+#include <Arduino.h>
+#include <vector>
+#include "device_controller.h"
+
+// Timestamp inicial padrão dos logs de teste (9 de outubro de 2025)
+#define TEST_LOG_START_TS 1760036598
+
+/**
+ * @brief Sensor para o qual se geram leituras simuladas. Com 'sensor', o valor sai da
+ * calibração real; sem ele (sensores sintéticos dos benchmarks), é raw / 100.
+ */
+struct TestLogSensor {
+    String sensorId;
+    String sensorType;
+    String unit;
+    Sensor* sensor;
+};
+
+/**
+ * @brief Gera 'cycles' ciclos de leituras simuladas, um registo por sensor em cada ciclo,
+ * avançando 'stepSeconds' a cada registo. Grava com logSensorReading(), como o firmware.
+ * @return Número de registos gerados.
+ */
+uint32_t generateTestLogs(const std::vector<TestLogSensor>& sensors, time_t startTs, uint32_t cycles, uint32_t stepSeconds);
+
+// Utilitário de desenvolvimento: 10 ciclos para os sensores configurados, 5 s entre registos
+void generateTestLogs(DeviceController& device);
+
+#endif
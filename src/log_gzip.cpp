@@ -0,0 +1,460 @@
+#include "log_gzip.h"
+#include <LittleFS.h>
+
+#define GZIP_MIN_MATCH 3
+#define GZIP_MAX_MATCH 258
+#define GZIP_MAX_CHAIN 16 // candidatos testados por posição (velocidade contra taxa)
+#define GZIP_HASH_SIZE (1 << LOG_GZIP_HASH_BITS)
+
+// Tabelas do deflate (RFC 1951, 3.2.5): comprimentos 257..285 e distâncias 0..29
+static const uint16_t LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                         35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                         3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t DIST_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                       257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                       8193, 12289, 16385, 24577};
+static const uint8_t DIST_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                       7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+uint32_t logCrc32(uint32_t crc, const uint8_t* data, size_t len) {
+    // Tabela de 4 bits: 64 bytes de flash em vez de 1 KB
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+static void putLe32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out[i] = (uint8_t)(value >> (8 * i));
+}
+
+// --- LogGzipWriter ---
+
+LogGzipWriter::LogGzipWriter()
+    : _out(nullptr), _ok(false), _crc(0), _inputSize(0), _fill(0), _pos(0),
+      _bitBuf(0), _bitCount(0), _outLen(0) {}
+
+bool LogGzipWriter::begin(File& out, uint32_t mtime) {
+    _out = &out;
+    _ok = true;
+    _crc = 0;
+    _inputSize = 0;
+    _fill = 0;
+    _pos = 0;
+    _bitBuf = 0;
+    _bitCount = 0;
+    _outLen = 0;
+    memset(_head, 0, sizeof(_head));
+    memset(_prev, 0, sizeof(_prev));
+
+    // ID1 ID2, CM=8 (deflate), sem flags, MTIME, XFL=0, OS=255 (desconhecido)
+    uint8_t header[10] = {0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF};
+    putLe32(header + 4, mtime);
+    for (uint8_t b : header) _putByte(b);
+
+    // Um único bloco, final, com Huffman fixo
+    _putBits(1, 1);
+    _putBits(1, 2);
+    return _ok;
+}
+
+bool LogGzipWriter::write(const uint8_t* data, size_t len) {
+    _crc = logCrc32(_crc, data, len);
+    _inputSize += len;
+    while (len > 0) {
+        size_t n = std::min(len, sizeof(_buf) - _fill);
+        memcpy(_buf + _fill, data, n);
+        _fill += n;
+        data += n;
+        len -= n;
+        if (_fill == sizeof(_buf)) {
+            _compress(false);
+            _slide();
+        }
+    }
+    return _ok;
+}
+
+bool LogGzipWriter::finish() {
+    _compress(true);
+    _putCode(0, 7); // símbolo 256: fim do bloco
+    if (_bitCount > 0) _putBits(0, 8 - _bitCount);
+
+    uint8_t trailer[8];
+    putLe32(trailer, _crc);
+    putLe32(trailer + 4, _inputSize);
+    for (uint8_t b : trailer) _putByte(b);
+    _flushOut();
+    return _ok;
+}
+
+uint32_t LogGzipWriter::crc() const {
+    return _crc;
+}
+
+uint32_t LogGzipWriter::inputSize() const {
+    return _inputSize;
+}
+
+static inline uint16_t gzipHash(const uint8_t* p) {
+    return (uint16_t)(((p[0] << 6) ^ (p[1] << 3) ^ p[2]) & (GZIP_HASH_SIZE - 1));
+}
+
+void LogGzipWriter::_insertHash(size_t pos) {
+    if (pos + GZIP_MIN_MATCH > _fill) return;
+    uint16_t h = gzipHash(_buf + pos);
+    _prev[pos & (LOG_GZIP_WINDOW - 1)] = _head[h];
+    _head[h] = (uint16_t)(pos + 1);
+}
+
+// LZ77 guloso; sem 'flush' deixa pelo menos GZIP_MAX_MATCH bytes por codificar à espera de mais entrada
+void LogGzipWriter::_compress(bool flush) {
+    while (_pos < _fill) {
+        size_t avail = _fill - _pos;
+        if (!flush && avail < GZIP_MAX_MATCH) break;
+
+        size_t bestLen = 0;
+        size_t bestDist = 0;
+        if (avail >= GZIP_MIN_MATCH) {
+            size_t maxLen = std::min(avail, (size_t)GZIP_MAX_MATCH);
+            uint16_t cand = _head[gzipHash(_buf + _pos)];
+            for (int chain = 0; cand != 0 && chain < GZIP_MAX_CHAIN; chain++) {
+                size_t c = cand - 1;
+                if (_pos - c > LOG_GZIP_WINDOW) break;
+                if (_buf[c + bestLen] == _buf[_pos + bestLen]) {
+                    size_t len = 0;
+                    while (len < maxLen && _buf[c + len] == _buf[_pos + len]) len++;
+                    if (len > bestLen) {
+                        bestLen = len;
+                        bestDist = _pos - c;
+                        if (len == maxLen) break;
+                    }
+                }
+                uint16_t next = _prev[c & (LOG_GZIP_WINDOW - 1)];
+                if (next >= cand) break; // elo reaproveitado por uma posição mais recente
+                cand = next;
+            }
+        }
+
+        if (bestLen >= GZIP_MIN_MATCH) {
+            _putMatch(bestLen, bestDist);
+            for (size_t i = 0; i < bestLen; i++) _insertHash(_pos + i);
+            _pos += bestLen;
+        } else {
+            _putLiteral(_buf[_pos]);
+            _insertHash(_pos);
+            _pos++;
+        }
+    }
+}
+
+// Descarta a metade mais antiga do buffer; as posições guardadas recuam LOG_GZIP_WINDOW
+void LogGzipWriter::_slide() {
+    memmove(_buf, _buf + LOG_GZIP_WINDOW, _fill - LOG_GZIP_WINDOW);
+    _fill -= LOG_GZIP_WINDOW;
+    _pos -= LOG_GZIP_WINDOW;
+    for (uint16_t& h : _head) h = h > LOG_GZIP_WINDOW ? h - LOG_GZIP_WINDOW : 0;
+    for (uint16_t& p : _prev) p = p > LOG_GZIP_WINDOW ? p - LOG_GZIP_WINDOW : 0;
+}
+
+void LogGzipWriter::_putBits(uint32_t value, uint8_t count) {
+    _bitBuf |= value << _bitCount;
+    _bitCount += count;
+    while (_bitCount >= 8) {
+        _putByte((uint8_t)_bitBuf);
+        _bitBuf >>= 8;
+        _bitCount -= 8;
+    }
+}
+
+// Os códigos de Huffman vão para o fluxo a partir do bit mais significativo
+void LogGzipWriter::_putCode(uint16_t code, uint8_t len) {
+    uint16_t reversed = 0;
+    for (uint8_t i = 0; i < len; i++) {
+        reversed = (reversed << 1) | (code & 1);
+        code >>= 1;
+    }
+    _putBits(reversed, len);
+}
+
+void LogGzipWriter::_putLiteral(uint8_t c) {
+    if (c < 144) _putCode(0x30 + c, 8);
+    else _putCode(0x190 + (c - 144), 9);
+}
+
+void LogGzipWriter::_putMatch(size_t len, size_t dist) {
+    int l = 28;
+    while (LENGTH_BASE[l] > len) l--;
+    uint16_t sym = 257 + l;
+    if (sym < 280) _putCode(sym - 256, 7);
+    else _putCode(0xC0 + (sym - 280), 8);
+    _putBits(len - LENGTH_BASE[l], LENGTH_EXTRA[l]);
+
+    int d = 29;
+    while (DIST_BASE[d] > dist) d--;
+    _putCode(d, 5);
+    _putBits(dist - DIST_BASE[d], DIST_EXTRA[d]);
+}
+
+void LogGzipWriter::_putByte(uint8_t b) {
+    _outBuf[_outLen++] = b;
+    if (_outLen == sizeof(_outBuf)) _flushOut();
+}
+
+void LogGzipWriter::_flushOut() {
+    if (_outLen == 0) return;
+    if (!_out || _out->write(_outBuf, _outLen) != _outLen) _ok = false;
+    _outLen = 0;
+}
+
+// --- LogGzipReader ---
+
+LogGzipReader::LogGzipReader()
+    : _dataStart(0), _size(0), _pos(0), _state(DONE), _final(false), _storedLeft(0),
+      _copyLen(0), _copyDist(0), _bitBuf(0), _bitCount(0), _inLen(0), _inPos(0) {}
+
+bool LogGzipReader::open(const String& path) {
+    close();
+    _file = LittleFS.open(path, "r");
+    if (!_file) return false;
+
+    // Cabeçalho fixo, campos opcionais (FEXTRA, FNAME, FCOMMENT, FHCRC) e ISIZE no fim
+    uint8_t header[10];
+    uint8_t trailer[4];
+    bool ok = _file.size() >= 18 && _file.read(header, sizeof(header)) == sizeof(header) &&
+              header[0] == 0x1F && header[1] == 0x8B && header[2] == 8;
+    uint8_t flags = ok ? header[3] : 0;
+    if (ok && (flags & 0x04)) {
+        uint8_t xlen[2];
+        ok = _file.read(xlen, 2) == 2 && _file.seek(_file.position() + (xlen[0] | (xlen[1] << 8)));
+    }
+    for (uint8_t flag : {0x08, 0x10}) {
+        if (!ok || !(flags & flag)) continue;
+        int c;
+        while ((c = _file.read()) > 0) {}
+        ok = (c == 0);
+    }
+    if (ok && (flags & 0x02)) ok = _file.seek(_file.position() + 2);
+
+    _dataStart = _file.position();
+    ok = ok && _file.seek(_file.size() - 4) && _file.read(trailer, 4) == 4;
+    if (!ok) {
+        Serial.printf("⚠️ Ficheiro gzip inválido: %s\n", path.c_str());
+        _file.close();
+        return false;
+    }
+    _size = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | ((uint32_t)trailer[3] << 24);
+    return _restart();
+}
+
+void LogGzipReader::close() {
+    if (_file) _file.close();
+    _state = DONE;
+}
+
+bool LogGzipReader::isOpen() const {
+    return (bool)_file;
+}
+
+bool LogGzipReader::_restart() {
+    _pos = 0;
+    _state = BLOCK_HEADER;
+    _final = false;
+    _storedLeft = 0;
+    _copyLen = 0;
+    _bitBuf = 0;
+    _bitCount = 0;
+    _inLen = 0;
+    _inPos = 0;
+    return _file.seek(_dataStart);
+}
+
+int LogGzipReader::read() {
+    return _next();
+}
+
+size_t LogGzipReader::read(uint8_t* buf, size_t len) {
+    size_t n = 0;
+    int c;
+    while (n < len && (c = _next()) >= 0) buf[n++] = (uint8_t)c;
+    return n;
+}
+
+size_t LogGzipReader::available() const {
+    return _state == DONE || _pos >= _size ? 0 : _size - _pos;
+}
+
+size_t LogGzipReader::position() const {
+    return _pos;
+}
+
+bool LogGzipReader::seek(size_t pos) {
+    if (!_file) return false;
+    // Até ao fim: não vale a pena descomprimir o que falta
+    if (pos >= _size) {
+        _finish();
+        _pos = _size;
+        return pos == _size;
+    }
+    if (pos < _pos && !_restart()) return false;
+    while (_pos < pos && _next() >= 0) {}
+    return _pos == pos;
+}
+
+size_t LogGzipReader::size() const {
+    return _size;
+}
+
+size_t LogGzipReader::compressedSize() {
+    return _file ? _file.size() : 0;
+}
+
+time_t LogGzipReader::lastWrite() {
+    return _file ? _file.getLastWrite() : 0;
+}
+
+int LogGzipReader::_finish() {
+    _state = DONE;
+    _copyLen = 0;
+    return -1;
+}
+
+int LogGzipReader::_inByte() {
+    if (_inPos == _inLen) {
+        _inLen = _file.read(_in, sizeof(_in));
+        _inPos = 0;
+        if (_inLen == 0) return -1;
+    }
+    return _in[_inPos++];
+}
+
+bool LogGzipReader::_needBits(uint8_t count) {
+    while (_bitCount < count) {
+        int b = _inByte();
+        if (b < 0) return false;
+        _bitBuf |= (uint32_t)b << _bitCount;
+        _bitCount += 8;
+    }
+    return true;
+}
+
+int LogGzipReader::_bits(uint8_t count) {
+    if (count == 0) return 0;
+    if (!_needBits(count)) return -1;
+    int value = _bitBuf & ((1UL << count) - 1);
+    _bitBuf >>= count;
+    _bitCount -= count;
+    return value;
+}
+
+int LogGzipReader::_huffBits(uint8_t count) {
+    int code = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        int bit = _bits(1);
+        if (bit < 0) return -1;
+        code = (code << 1) | bit;
+    }
+    return code;
+}
+
+// Huffman fixo: 7 bits para 256..279, 8 para 0..143 e 280..287, 9 para 144..255
+int LogGzipReader::_decodeLitLen() {
+    int code = _huffBits(7);
+    if (code < 0) return -1;
+    if (code <= 0x17) return 256 + code;
+
+    int bit = _bits(1);
+    if (bit < 0) return -1;
+    code = (code << 1) | bit;
+    if (code >= 0x30 && code <= 0xBF) return code - 0x30;
+    if (code >= 0xC0 && code <= 0xC7) return 280 + (code - 0xC0);
+
+    bit = _bits(1);
+    if (bit < 0) return -1;
+    code = (code << 1) | bit;
+    if (code >= 0x190 && code <= 0x1FF) return 144 + (code - 0x190);
+    return -1;
+}
+
+int LogGzipReader::_next() {
+    for (;;) {
+        if (_copyLen > 0) {
+            uint8_t c = _window[(_pos - _copyDist) & (LOG_GZIP_WINDOW - 1)];
+            _copyLen--;
+            _window[_pos++ & (LOG_GZIP_WINDOW - 1)] = c;
+            return c;
+        }
+
+        switch (_state) {
+        case BLOCK_HEADER: {
+            if (_final) return _finish();
+            int bfinal = _bits(1);
+            int type = _bits(2);
+            if (bfinal < 0 || type < 0) return _finish();
+            _final = (bfinal == 1);
+            if (type == 1) {
+                _state = FIXED;
+            } else if (type == 0) {
+                // Bloco sem compressão: alinha ao byte e lê LEN/NLEN
+                _bits(_bitCount % 8);
+                int len = _bits(16);
+                int nlen = _bits(16);
+                if (len < 0 || nlen < 0 || (len ^ 0xFFFF) != nlen) return _finish();
+                _storedLeft = len;
+                _state = STORED;
+            } else {
+                // O compressor daqui só grava Huffman fixo
+                Serial.println("⚠️ Bloco deflate com Huffman dinâmico não suportado.");
+                return _finish();
+            }
+            continue;
+        }
+        case STORED: {
+            if (_storedLeft == 0) {
+                _state = BLOCK_HEADER;
+                continue;
+            }
+            int c = _bits(8);
+            if (c < 0) return _finish();
+            _storedLeft--;
+            _window[_pos++ & (LOG_GZIP_WINDOW - 1)] = (uint8_t)c;
+            return c;
+        }
+        case FIXED: {
+            int sym = _decodeLitLen();
+            if (sym < 0) return _finish();
+            if (sym < 256) {
+                _window[_pos++ & (LOG_GZIP_WINDOW - 1)] = (uint8_t)sym;
+                return sym;
+            }
+            if (sym == 256) {
+                _state = BLOCK_HEADER;
+                continue;
+            }
+            sym -= 257;
+            if (sym >= 29) return _finish();
+            int extra = _bits(LENGTH_EXTRA[sym]);
+            int dsym = _huffBits(5);
+            if (extra < 0 || dsym < 0 || dsym >= 30) return _finish();
+            int dextra = _bits(DIST_EXTRA[dsym]);
+            if (dextra < 0) return _finish();
+
+            size_t dist = DIST_BASE[dsym] + dextra;
+            if (dist > _pos || dist > LOG_GZIP_WINDOW) return _finish(); // fora da janela deste leitor
+            _copyLen = LENGTH_BASE[sym] + extra;
+            _copyDist = dist;
+            continue;
+        }
+        case DONE:
+        default:
+            return -1;
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#ifndef LOG_GZIP_H
+#define LOG_GZIP_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+// Janela do LZ77: o compressor nunca refere bytes mais antigos, por isso o leitor só guarda isto
+#define LOG_GZIP_WINDOW 4096
+#define LOG_GZIP_HASH_BITS 11
+
+// CRC-32 do gzip (polinómio 0xEDB88320); 'crc' é o valor acumulado (0 no início)
+uint32_t logCrc32(uint32_t crc, const uint8_t* data, size_t len);
+
+/**
+ * @brief Compressor gzip (deflate com códigos de Huffman fixos) de memória fixa, alimentado aos
+ * poucos pela compactação dos dias fechados. Comprime menos que o zlib, mas usa ~20 KB de RAM e
+ * o resultado abre em qualquer gunzip ou navegador (Content-Encoding: gzip).
+ */
+class LogGzipWriter {
+public:
+    LogGzipWriter();
+
+    bool begin(File& out, uint32_t mtime); // grava o cabeçalho gzip
+    bool write(const uint8_t* data, size_t len);
+    bool finish(); // comprime o resto e grava o bloco final e o trailer (CRC-32 e tamanho)
+
+    uint32_t crc() const;
+    uint32_t inputSize() const;
+
+private:
+    void _compress(bool flush);
+    void _slide();
+    void _insertHash(size_t pos);
+    void _putBits(uint32_t value, uint8_t count);
+    void _putCode(uint16_t code, uint8_t len);
+    void _putLiteral(uint8_t c);
+    void _putMatch(size_t len, size_t dist);
+    void _putByte(uint8_t b);
+    void _flushOut();
+
+    File* _out;
+    bool _ok;
+    uint32_t _crc;
+    uint32_t _inputSize;
+
+    uint8_t _buf[2 * LOG_GZIP_WINDOW]; // janela já codificada + bytes à espera
+    size_t _fill;
+    size_t _pos;
+    uint16_t _head[1 << LOG_GZIP_HASH_BITS]; // última posição (+1) de cada hash de 3 bytes
+    uint16_t _prev[LOG_GZIP_WINDOW];         // posição anterior com o mesmo hash
+
+    uint32_t _bitBuf;
+    uint8_t _bitCount;
+    uint8_t _outBuf[256];
+    size_t _outLen;
+};
+
+/**
+ * @brief Leitor sequencial de um ficheiro .gz gravado pelo LogGzipWriter.
+ * Posições e tamanho referem-se aos bytes descomprimidos; seek para trás recomeça do início.
+ */
+class LogGzipReader {
+public:
+    LogGzipReader();
+
+    bool open(const String& path);
+    void close();
+    bool isOpen() const;
+
+    int read(); // próximo byte, -1 no fim
+    size_t read(uint8_t* buf, size_t len);
+    size_t available() const;
+
+    size_t position() const;
+    bool seek(size_t pos);
+    size_t size() const;          // tamanho descomprimido (ISIZE do trailer)
+    size_t compressedSize();
+    time_t lastWrite();
+
+private:
+    enum State : uint8_t { BLOCK_HEADER, STORED, FIXED, DONE };
+
+    bool _restart();
+    int _next();
+    int _inByte();
+    bool _needBits(uint8_t count);
+    int _bits(uint8_t count);     // LSB primeiro (cabeçalhos e bits extra)
+    int _huffBits(uint8_t count); // MSB primeiro (códigos de Huffman)
+    int _decodeLitLen();
+    int _finish();
+
+    File _file;
+    size_t _dataStart;
+    size_t _size;
+    size_t _pos;
+
+    State _state;
+    bool _final;
+    size_t _storedLeft;
+    size_t _copyLen;
+    size_t _copyDist;
+
+    uint32_t _bitBuf;
+    uint8_t _bitCount;
+    uint8_t _in[64];
+    size_t _inLen;
+    size_t _inPos;
+    uint8_t _window[LOG_GZIP_WINDOW];
+};
+
+#endif
@@ -8,50 +8,11 @@
 #include "data_logger.h"
 #include <LittleFS.h>
 #include "rtc_service.h"
+#include "log_generator.h"
 #include <Wire.h>
 
-void generateTestLogs(DeviceController& device) {
-  Serial.println("\n=========================================");
-  Serial.println("INICIANDO GERAÇÃO DE LOGS DE TESTE...");
-  Serial.println("=========================================");
-
-  // Pega na lista de sensores que o DeviceController criou
-  const auto& sensors = device.getSensors();
-  if (sensors.empty()) {
-    Serial.println("Nenhum sensor configurado. Teste abortado.");
-    return;
-  }
-
-  // Define um timestamp inicial (ex: 1 de Outubro de 2025)
-  time_t current_ts = 1760036598; 
-
-  // Loop principal: 1 a 100
-  for (int i = 0; i < 10; i++) {
-    
-    // Loop secundário: para cada sensor na nossa lista
-    for (auto sensor : sensors) {
-      if (sensor) {
-        // Simula uma leitura de sensor
-        int raw = random(1000, 3000);
-        float value = sensor->getValue(raw); // Usamos o método de calibração real
-
-        // Chama a nossa função de log com o timestamp controlado
-        logSensorReading(current_ts, sensor->getSensorId(),sensor->getUnit(), raw, value);
-
-        // Incrementa o tempo para o próximo registo
-        current_ts += 5; 
-      }
-    }
-    Serial.printf("Ciclo de geração %d/100 completo.\n", i + 1);
-    delay(10); // Pequena pausa para não bloquear o serial
-  }
-
-  Serial.println("=========================================");
-  Serial.println("GERAÇÃO DE LOGS DE TESTE CONCLUÍDA.");
-  Serial.println("Pode reiniciar o dispositivo ou iniciar a sincronização.");
-  Serial.println("=========================================");
-}
-
+// Teto do sono do loop(): comandos BLE e o flush do logger não esperam mais do que isto
+#define LOOP_MAX_SLEEP_MS 100UL
 
 void listAllFiles(const char* basePath, int indent = 0) {
     File dir = LittleFS.open(basePath);
@@ -173,17 +134,15 @@ void setup() {
 
 }
 void loop() {
-    if (meuDevice.isReady()) {
-    // Obtém a lista de sensores do controlador
-    const auto& sensors = meuDevice.getSensors();
-    
-    // Itera sobre cada sensor e chama o seu método update().
-    // Esta é a forma dinâmica e escalável de fazer o que você já fazia com os 'if's.
-    for (auto sensor : sensors) {
-      if (sensor) {
-        sensor->update();
-      }
-    }
+  unsigned long sleepMs = LOOP_MAX_SLEEP_MS;
+  if (meuDevice.isReady()) {
+    // O agendador só lê os sensores cujo prazo (amostragem ou notificação) venceu
+    // e diz quanto falta para o próximo.
+    sleepMs = min(meuDevice.runScheduler(), LOOP_MAX_SLEEP_MS);
   }
+  loopDataLogger();
   loopBLE(meuDevice);
+
+  // Até ao próximo prazo o core fica livre (sem ADC/OneWire desnecessários)
+  if (sleepMs > 0) delay(sleepMs);
 }
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include "sensor_rollup.h"
+#include <LittleFS.h>
+#include <algorithm>
+#include <map>
+#include <math.h>
+#include "data_logger.h"
+#include "log_format.h"
+
+// sensorIndex deste arranque e, por ficheiro (dia), que sensores já têm a entrada 'S' gravada
+static std::vector<String> _sensorIds;
+static std::map<uint32_t, std::vector<bool>> _tablesWritten;
+
+void RollupStats::reset(uint32_t windowStart, uint32_t window) {
+    start = windowStart;
+    windowSec = window;
+    count = 0;
+    min = 0;
+    max = 0;
+    last = 0;
+    sum = 0;
+}
+
+void RollupStats::add(float value) {
+    if (isnan(value)) return; // leitura inválida (sensor desligado) não entra nas contas
+    if (count == 0 || value < min) min = value;
+    if (count == 0 || value > max) max = value;
+    last = value;
+    sum += value;
+    count++;
+}
+
+float RollupStats::mean() const {
+    return count > 0 ? (float)(sum / count) : 0.0f;
+}
+
+static uint32_t _dayOf(time_t timestamp) {
+    struct tm timeinfo;
+    localtime_r(&timestamp, &timeinfo);
+    return (timeinfo.tm_year + 1900) * 10000 + (timeinfo.tm_mon + 1) * 100 + timeinfo.tm_mday;
+}
+
+static String _rollupPath(uint32_t day) {
+    char path[40];
+    snprintf(path, sizeof(path), "%s/%04u_%02u_%02u%s", ROLLUP_DIR,
+             (unsigned)(day / 10000), (unsigned)(day / 100 % 100), (unsigned)(day % 100), ROLLUP_EXT);
+    return String(path);
+}
+
+static String _baseName(const String& path) {
+    int slash = path.lastIndexOf('/');
+    return slash >= 0 ? path.substring(slash + 1) : path;
+}
+
+static uint8_t _sensorIndexOf(const String& sensorId) {
+    for (size_t i = 0; i < _sensorIds.size(); i++) {
+        if (_sensorIds[i] == sensorId) return i;
+    }
+    _sensorIds.push_back(sensorId);
+    return _sensorIds.size() - 1;
+}
+
+bool appendRollup(const String& sensorId, const RollupStats& stats) {
+    if (stats.count == 0) return false;
+    LogReadLock lock;
+
+    uint32_t day = _dayOf(stats.start);
+    uint8_t index = _sensorIndexOf(sensorId);
+    // Só o dia corrente e o anterior (janelas de um dia fecham já no dia seguinte) recebem agregados
+    _tablesWritten[day];
+    while (_tablesWritten.size() > 2 && _tablesWritten.begin()->first != day) _tablesWritten.erase(_tablesWritten.begin());
+    std::vector<bool>& written = _tablesWritten[day];
+    if (written.size() < _sensorIds.size()) written.resize(_sensorIds.size(), false);
+
+    if (!LittleFS.exists(ROLLUP_DIR)) LittleFS.mkdir(ROLLUP_DIR);
+    String path = _rollupPath(day);
+    File out = LittleFS.open(path, "a");
+    if (!out) {
+        Serial.printf("❌ Falha ao abrir %s para os agregados.\n", path.c_str());
+        return false;
+    }
+
+    bool ok = true;
+    if (!written[index]) {
+        RollupSensorEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.tag = ROLLUP_TAG_SENSOR;
+        entry.sensorIndex = index;
+        strncpy(entry.sensorId, sensorId.c_str(), sizeof(entry.sensorId) - 1);
+        entry.crc = logCrc8((const uint8_t*)&entry, sizeof(entry) - 1);
+        ok = out.write((const uint8_t*)&entry, sizeof(entry)) == sizeof(entry);
+        if (ok) written[index] = true;
+    }
+
+    RollupRecord record = { ROLLUP_TAG_RECORD, index, stats.start, stats.windowSec, stats.count,
+                            stats.min, stats.max, stats.mean(), stats.last, 0 };
+    record.crc = logCrc8((const uint8_t*)&record, sizeof(record) - 1);
+    ok = ok && out.write((const uint8_t*)&record, sizeof(record)) == sizeof(record);
+    out.close();
+
+    if (!ok) Serial.printf("❌ Falha ao gravar o agregado de %s em %s.\n", sensorId.c_str(), path.c_str());
+    return ok;
+}
+
+// Lê um ficheiro do dia; uma entrada com etiqueta desconhecida (ficheiro truncado) termina a leitura
+static void _readRollupFile(const String& path, const String& sensorId, uint32_t windowSec,
+                            time_t since, time_t until, std::vector<RollupEntry>& entries) {
+    File in = LittleFS.open(path, "r");
+    if (!in) return;
+
+    std::map<uint8_t, String> sensors;
+    uint8_t buf[sizeof(RollupSensorEntry) > sizeof(RollupRecord) ? sizeof(RollupSensorEntry) : sizeof(RollupRecord)];
+    while (in.read(buf, 1) == 1) {
+        size_t size = (buf[0] == ROLLUP_TAG_SENSOR) ? sizeof(RollupSensorEntry)
+                    : (buf[0] == ROLLUP_TAG_RECORD) ? sizeof(RollupRecord) : 0;
+        if (size == 0 || in.read(buf + 1, size - 1) != size - 1) break;
+        if (logCrc8(buf, size - 1) != buf[size - 1]) continue;
+
+        if (buf[0] == ROLLUP_TAG_SENSOR) {
+            RollupSensorEntry entry;
+            memcpy(&entry, buf, sizeof(entry));
+            entry.sensorId[sizeof(entry.sensorId) - 1] = '\0';
+            sensors[entry.sensorIndex] = String(entry.sensorId);
+            continue;
+        }
+
+        RollupRecord record;
+        memcpy(&record, buf, sizeof(record));
+        auto it = sensors.find(record.sensorIndex);
+        if (it == sensors.end()) continue;
+        if (sensorId.length() > 0 && it->second != sensorId) continue;
+        if (windowSec != 0 && record.windowSec != windowSec) continue;
+        if (since != 0 && (time_t)record.start < since) continue;
+        if (until != 0 && (time_t)record.start > until) continue;
+
+        RollupEntry entry = { it->second, record.windowSec, record.start, record.count,
+                              record.min, record.max, record.mean, record.last, false };
+        entries.push_back(entry);
+    }
+    in.close();
+}
+
+std::vector<RollupEntry> readRollups(const String& sensorId, uint32_t windowSec, time_t since, time_t until,
+                                     size_t maxRecords) {
+    std::vector<RollupEntry> entries;
+    LogReadLock lock;
+
+    std::vector<String> names;
+    File dir = LittleFS.open(ROLLUP_DIR);
+    if (!dir || !dir.isDirectory()) return entries;
+    File f = dir.openNextFile();
+    while (f) {
+        String name = _baseName(String(f.name()));
+        f.close();
+        if (name.endsWith(ROLLUP_EXT) &&
+            isLogDayInRange(name.substring(0, name.length() - strlen(ROLLUP_EXT)), since, until)) {
+            names.push_back(name);
+        }
+        f = dir.openNextFile();
+    }
+    dir.close();
+
+    std::sort(names.begin(), names.end()); // AAAA_MM_DD: ordem alfabética = cronológica
+    for (const String& name : names) {
+        _readRollupFile(String(ROLLUP_DIR) + "/" + name, sensorId, windowSec, since, until, entries);
+        if (maxRecords > 0 && entries.size() > maxRecords) break; // o resto fica para a página seguinte
+    }
+
+    // Dentro do ficheiro as janelas ficam pela ordem em que fecharam (as de um dia, só no dia seguinte)
+    std::stable_sort(entries.begin(), entries.end(), [](const RollupEntry& a, const RollupEntry& b) {
+        return a.start < b.start;
+    });
+    return entries;
+}
+
+uint32_t pruneRollupFiles(uint16_t maxDays) {
+    time_t now = time(nullptr);
+    if (maxDays == 0 || now < 1704067200) return 0; // relógio por acertar: não há como saber a idade
+
+    LogReadLock lock;
+    std::vector<String> expired;
+    time_t cutoff = now - (time_t)maxDays * 86400;
+    File dir = LittleFS.open(ROLLUP_DIR);
+    if (!dir || !dir.isDirectory()) return 0;
+    File f = dir.openNextFile();
+    while (f) {
+        String name = _baseName(String(f.name()));
+        f.close();
+        time_t dayStart, dayEnd;
+        if (name.endsWith(ROLLUP_EXT) &&
+            getLogDayBounds(name.substring(0, name.length() - strlen(ROLLUP_EXT)), dayStart, dayEnd) &&
+            dayEnd < cutoff) {
+            expired.push_back(name);
+        }
+        f = dir.openNextFile();
+    }
+    dir.close();
+
+    uint32_t removed = 0;
+    for (const String& name : expired) {
+        if (LittleFS.remove(String(ROLLUP_DIR) + "/" + name)) removed++;
+    }
+    if (removed > 0) Serial.printf("🧹 %u ficheiro(s) de agregados apagados (mais de %u dias).\n",
+                                   (unsigned)removed, (unsigned)maxDays);
+    return removed;
+}
@@ -0,0 +1,90 @@
+#ifndef SENSOR_ROLLUP_H
+#define SENSOR_ROLLUP_H
+
+#include <Arduino.h>
+#include <vector>
+
+// Agregados por janela (min, max, média, contagem, último), um ficheiro por dia: /rollups/AAAA_MM_DD.rlp
+#define ROLLUP_DIR "/rollups"
+#define ROLLUP_EXT ".rlp"
+
+// Entradas do ficheiro: a tabela de sensores ('S') diz de quem é cada sensorIndex dos agregados ('R')
+#define ROLLUP_TAG_SENSOR 'S'
+#define ROLLUP_TAG_RECORD 'R'
+
+/**
+ * @brief Associa um sensorIndex ao id do sensor nos agregados que se seguem no ficheiro.
+ * Gravada antes do primeiro agregado de cada sensor em cada ficheiro (e de novo após um reinício).
+ */
+struct __attribute__((packed)) RollupSensorEntry {
+    uint8_t tag;        // ROLLUP_TAG_SENSOR
+    uint8_t sensorIndex;
+    char sensorId[32];
+    uint8_t crc;        // CRC-8 dos bytes anteriores
+};
+
+/**
+ * @brief Agregado de uma janela fechada (31 bytes contra ~110 de uma só linha JSONL).
+ */
+struct __attribute__((packed)) RollupRecord {
+    uint8_t tag;        // ROLLUP_TAG_RECORD
+    uint8_t sensorIndex;
+    uint32_t start;     // epoch do início da janela (múltiplo de windowSec)
+    uint32_t windowSec;
+    uint32_t count;
+    float min;
+    float max;
+    float mean;
+    float last;
+    uint8_t crc;
+};
+
+/**
+ * @brief Acumulador em RAM da janela aberta de um sensor.
+ */
+struct RollupStats {
+    uint32_t start;
+    uint32_t windowSec;
+    uint32_t count;
+    float min;
+    float max;
+    float last;
+    double sum;
+
+    void reset(uint32_t windowStart, uint32_t window);
+    void add(float value);
+    float mean() const;
+};
+
+/**
+ * @brief Agregado lido de um ficheiro (ou copiado da janela ainda aberta, com partial = true).
+ */
+struct RollupEntry {
+    String sensorId;
+    uint32_t windowSec;
+    uint32_t start;
+    uint32_t count;
+    float min;
+    float max;
+    float mean;
+    float last;
+    bool partial;
+};
+
+// Grava a janela fechada no ficheiro do dia em que começou
+bool appendRollup(const String& sensorId, const RollupStats& stats);
+
+/**
+ * @brief Agregados gravados com início em [since, until] (0 = sem limite), ordenados por início.
+ * @param sensorId Sensor pedido; vazio = todos.
+ * @param windowSec Duração da janela; 0 = todas.
+ * @param maxRecords Para de ler no fim do ficheiro do dia em que passa de maxRecords (0 = todos): os agregados
+ * de um início ficam todos no mesmo ficheiro, por isso a página cortada não perde nenhum.
+ */
+std::vector<RollupEntry> readRollups(const String& sensorId, uint32_t windowSec, time_t since, time_t until,
+                                     size_t maxRecords = 0);
+
+// Apaga os ficheiros de dias com mais de maxDays (0 = guarda todos); retorna quantos
+uint32_t pruneRollupFiles(uint16_t maxDays);
+
+#endif
@@ -0,0 +1,80 @@
+#include "AnalogOversampler.h"
+
+AnalogOversampler::AnalogOversampler()
+    : _samples(1), _filter(AdcFilter::MEDIAN), _trim(0), _emaAlpha(0), _ema(0), _emaValid(false) {}
+
+void AnalogOversampler::configure(const JsonVariant& adcConfig) {
+    int samples = adcConfig["samples"] | 1;
+    _samples = constrain(samples, 1, ADC_OVERSAMPLE_MAX);
+
+    String filter = adcConfig["filter"] | "median";
+    if (filter == "trimmed_mean") _filter = AdcFilter::TRIMMED_MEAN;
+    else if (filter == "mean") _filter = AdcFilter::MEAN;
+    else _filter = AdcFilter::MEDIAN;
+
+    _trim = constrain(adcConfig["trim"] | 0.25f, 0.0f, ADC_TRIM_MAX);
+    _emaAlpha = constrain(adcConfig["ema_alpha"] | 0.0f, 0.0f, 1.0f);
+    resetFilter();
+
+    if (_samples > 1 || (_emaAlpha > 0 && _emaAlpha < 1)) {
+        Serial.printf("  -> ADC: %u leituras por amostra, filtro %s, ema_alpha=%.2f\n",
+                      (unsigned)_samples, filter.c_str(), _emaAlpha);
+    }
+}
+
+void AnalogOversampler::resetFilter() {
+    _emaValid = false;
+}
+
+float AnalogOversampler::_reduce(uint16_t* values, size_t count) const {
+    if (count == 1) return values[0];
+
+    // Ordenação por inserção: no máximo ADC_OVERSAMPLE_MAX valores, sem alocação
+    for (size_t i = 1; i < count; i++) {
+        uint16_t v = values[i];
+        size_t j = i;
+        while (j > 0 && values[j - 1] > v) {
+            values[j] = values[j - 1];
+            j--;
+        }
+        values[j] = v;
+    }
+
+    if (_filter == AdcFilter::MEDIAN) {
+        return (count % 2) ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2.0f;
+    }
+
+    size_t cut = (_filter == AdcFilter::TRIMMED_MEAN) ? (size_t)(count * _trim) : 0;
+    if (2 * cut >= count) cut = (count - 1) / 2;
+    uint32_t sum = 0;
+    for (size_t i = cut; i < count - cut; i++) sum += values[i];
+    return (float)sum / (count - 2 * cut);
+}
+
+float AnalogOversampler::_burst(uint8_t pin) const {
+    uint16_t values[ADC_OVERSAMPLE_MAX];
+    for (uint8_t i = 0; i < _samples; i++) values[i] = analogRead(pin);
+    return _reduce(values, _samples);
+}
+
+int AnalogOversampler::read(uint8_t pin) {
+    return (int)lroundf(_burst(pin));
+}
+
+int AnalogOversampler::readFiltered(uint8_t pin) {
+    float value = _burst(pin);
+    if (_emaAlpha > 0 && _emaAlpha < 1) {
+        if (!_emaValid) {
+            _ema = value;
+            _emaValid = true;
+        } else {
+            _ema += _emaAlpha * (value - _ema);
+        }
+        value = _ema;
+    }
+    return (int)lroundf(value);
+}
+
+uint8_t AnalogOversampler::samples() const { return _samples; }
+AdcFilter AnalogOversampler::filter() const { return _filter; }
+float AnalogOversampler::emaAlpha() const { return _emaAlpha; }
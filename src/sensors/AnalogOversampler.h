@@ -0,0 +1,65 @@
+#ifndef ANALOG_OVERSAMPLER_H
+#define ANALOG_OVERSAMPLER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Máximo de leituras do ADC por amostra (buffer fixo na pilha, 2 bytes cada)
+#define ADC_OVERSAMPLE_MAX 64
+// Fração máxima descartada em cada ponta na média aparada
+#define ADC_TRIM_MAX 0.45f
+
+// Redução das leituras de uma rajada a um só valor ("adc.filter" no JSON do sensor)
+enum class AdcFilter : uint8_t {
+    MEDIAN = 0,
+    TRIMMED_MEAN = 1,
+    MEAN = 2
+};
+
+/**
+ * @brief Sobreamostragem de um pino analógico: lê uma rajada de N amostras do ADC, reduz por
+ * mediana ou média aparada (rejeita picos de ruído) e aplica opcionalmente uma média móvel
+ * exponencial entre amostras gravadas. Sem bloco "adc" no JSON lê uma vez, como um analogRead simples.
+ */
+class AnalogOversampler {
+public:
+    AnalogOversampler();
+
+    /**
+     * @brief Lê o objeto "adc" do JSON do sensor:
+     * {"samples": 16, "filter": "median"|"trimmed_mean"|"mean", "trim": 0.25, "ema_alpha": 0.3}.
+     * ema_alpha 0 (ou 1) desliga o filtro exponencial.
+     */
+    void configure(const JsonVariant& adcConfig);
+
+    /**
+     * @brief Faz a rajada de leituras em 'pin' e devolve a redução, arredondada às unidades do ADC.
+     * Não usa nem altera a EMA: serve às notificações e ao /dados, que podem correr noutra tarefa.
+     */
+    int read(uint8_t pin);
+
+    /**
+     * @brief Como read(), mas avança a EMA. Só para a amostragem (Sensor::sample()), para que
+     * ema_alpha pese uma amostra por sampling.period_sec.
+     */
+    int readFiltered(uint8_t pin);
+
+    void resetFilter(); // a próxima leitura recomeça a média exponencial
+
+    uint8_t samples() const;
+    AdcFilter filter() const;
+    float emaAlpha() const;
+
+private:
+    float _reduce(uint16_t* values, size_t count) const;
+    float _burst(uint8_t pin) const;
+
+    uint8_t _samples;
+    AdcFilter _filter;
+    float _trim;
+    float _emaAlpha;
+    float _ema;
+    bool _emaValid;
+};
+
+#endif
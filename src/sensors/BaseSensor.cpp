@@ -23,6 +23,14 @@ void Sensor::configure(const JsonVariant& configJson) {
     _valorCriticoMax = configJson["valor_critico"]["max"];
     _valorCriticoMin = configJson["valor_critico"]["min"];
 
+    // Notificação BLE por mudança: banda morta na unidade do sensor e intervalos em ms
+    JsonVariant notifyCfg = configJson["notify"];
+    _notifyDeadband = notifyCfg["deadband"] | 0.0f;
+    _notifyMinIntervalMs = notifyCfg["min_interval_ms"] | SENSOR_NOTIFY_PERIOD_MS;
+    _notifyMaxIntervalMs = notifyCfg["max_interval_ms"] | SENSOR_NOTIFY_MAX_INTERVAL_MS;
+    if (_notifyMinIntervalMs == 0) _notifyMinIntervalMs = SENSOR_NOTIFY_PERIOD_MS;
+    if (_notifyMaxIntervalMs < _notifyMinIntervalMs) _notifyMaxIntervalMs = _notifyMinIntervalMs;
+
     // Inicializa o temporizador para permitir a primeira leitura imediatamente
     _lastSampleMillis = 0 - (_sampling_period_sec * 1000L);
     
@@ -30,32 +38,44 @@ void Sensor::configure(const JsonVariant& configJson) {
     Serial.println();
     // Chama o método virtual para que a classe filha configure a sua calibração específica
     _configureCalibration(configJson["calibration"]);
+    _configureAdc(configJson["adc"]);
 }
 
-// Implementação do método de ciclo de vida principal
+// Implementação do método de ciclo de vida principal.
+// O DeviceController agenda sample()/notify() diretamente; update() fica para quem chama o sensor por polling.
 void Sensor::update() {
-    //time_t current_ts = 1704067201; 
-   
-    time_t current_ts = rtcService.getTimestamp(); 
-    int rawValue = getRaw();
-    float calibratedValue = getValue(rawValue);
-        
-    _lastValue = calibratedValue;
     unsigned long currentMillis = millis();
-    if (currentMillis - _lastSampleMillis >= (_sampling_period_sec * 1000L)) {
-        _lastSampleMillis = currentMillis;
-        logSensorReading(current_ts, _sensor_id, _sensor_type, _unit, rawValue, calibratedValue);
-        Serial.println("🧾 Dado salvo no log.");
+    if (currentMillis - _lastSampleMillis >= getSamplingPeriodMs()) {
+        sample();
     }
-    // 📡 2. Controle da notificação BLE (a cada 2 segundos fixos)
-    if (currentMillis - _lastNotifyMillis >= 2000) {  // 2000 ms = 2 segundos
-        _lastNotifyMillis = currentMillis;
-        // Envia o último valor conhecido (_lastValue)
-        notifySensorValue(_sensor_id, _lastValue, _unit);
-        Serial.println("📡 Notificação BLE enviada.");
+    // 📡 2. Controle da notificação BLE
+    unsigned long notifyPeriod = getNotifyPeriodMs();
+    if (notifyPeriod > 0 && currentMillis - _lastNotifyMillis >= notifyPeriod) {
+        notifyIfChanged();
     }
 }
 
+void Sensor::sample() {
+    time_t current_ts = rtcService.getTimestamp();
+    int rawValue = getSampleRaw();
+    float calibratedValue = getValue(rawValue);
+
+    _lastValue = calibratedValue;
+    _lastSampleMillis = millis();
+    _recentSamples.push((uint32_t)current_ts, rawValue, calibratedValue);
+    logSensorReading(current_ts, _sensor_id, _sensor_type, _unit, rawValue, calibratedValue);
+    Serial.println("🧾 Dado salvo no log.");
+}
+
+unsigned long Sensor::getSamplingPeriodMs() const {
+    return (unsigned long)_sampling_period_sec * 1000UL;
+}
+
+// O agendador lê o sensor a cada intervalo mínimo; notifyIfChanged() decide se envia
+unsigned long Sensor::getNotifyPeriodMs() const {
+    return _notifyMinIntervalMs;
+}
+
 // Implementação dos Getters
 String Sensor::getSensorId() const {
     return _sensor_id;
@@ -83,13 +103,57 @@ void Sensor::notify() {
     if (!_ble_characteristic_uuid) return; // characteristic é o BLECharacteristic do sensor
     int rawValue = getRaw();
     float calibratedValue = getValue(rawValue);
-    notifySensorValue(_sensor_id, calibratedValue, _unit);
+    _lastValue = calibratedValue;
+    _sendNotify(calibratedValue);
   }
 
+bool Sensor::notifyIfChanged() {
+    if (!_ble_characteristic_uuid) return false;
+    int rawValue = getRaw();
+    float calibratedValue = getValue(rawValue);
+    _lastValue = calibratedValue;
+
+    // Cruzar um limite crítico não espera pelo intervalo nem pela banda morta
+    bool due = !_notifiedOnce ||
+               _criticalZone(calibratedValue) != _lastNotifiedZone ||
+               millis() - _lastNotifyMillis >= _notifyMaxIntervalMs ||
+               fabsf(calibratedValue - _lastNotifiedValue) > _notifyDeadband ||
+               isnan(calibratedValue) != isnan(_lastNotifiedValue);
+    if (!due) return false;
+    _sendNotify(calibratedValue);
+    return true;
+}
+
+void Sensor::_sendNotify(float value) {
+    _lastNotifyMillis = millis();
+    _lastNotifiedValue = value;
+    _lastNotifiedZone = _criticalZone(value);
+    _notifiedOnce = true;
+    notifySensorValue(_bleSlot, value);
+}
+
+int8_t Sensor::_criticalZone(float value) const {
+    if (value < _valorCriticoMin) return -1;
+    if (value > _valorCriticoMax) return 1;
+    return 0;
+}
+
 long Sensor::getSamplingPeriod() const{
     return _sampling_period_sec;
 }
 
 float Sensor::getLastValue() const{
     return _lastValue;
-}
\ No newline at end of file
+}
+
+const SampleRingBuffer& Sensor::getRecentSamples() const{
+    return _recentSamples;
+}
+
+void Sensor::setBleSlot(int slot){
+    _bleSlot = slot;
+}
+
+int Sensor::getBleSlot() const{
+    return _bleSlot;
+}
@@ -3,9 +3,14 @@
 
 #include <ArduinoJson.h>
 #include "../rtc_service.h"
+#include "SampleRingBuffer.h"
+
+// Intervalos padrão das notificações BLE em tempo real (sem "notify" no JSON do sensor: a cada 2 s, como antes)
+#define SENSOR_NOTIFY_PERIOD_MS 2000UL
+#define SENSOR_NOTIFY_MAX_INTERVAL_MS SENSOR_NOTIFY_PERIOD_MS
 // Forward declarations to avoid circular dependencies
 void logSensorReading(time_t timestamp, const String& sensorId,const String& sensorType, const String& unit, int rawValue, float calibratedValue);
-void notifySensorValue(const String& sensorId, float value, const String& unit);
+void notifySensorValue(int bleSlot, float value);
 
 class Sensor {
 public:
@@ -19,10 +24,29 @@ public:
     // O coração do sensor, chamado pelo loop principal
     virtual void update();
 
+    /**
+     * @brief Lê o sensor e grava a leitura no log. Chamado pelo agendador do
+     * DeviceController quando vence o período de amostragem.
+     */
+    virtual void sample();
+
+    // Períodos usados pelo agendador (0 = sem notificação própria)
+    unsigned long getSamplingPeriodMs() const;
+    virtual unsigned long getNotifyPeriodMs() const;
+
     virtual int getRaw() = 0;
     virtual float getValue(int rawValue) = 0;
+    // Raw da amostra gravada; os sensores com filtro entre amostras (EMA) só o avançam aqui
+    virtual int getSampleRaw() { return getRaw(); }
     
-    void notify();
+    void notify(); // notifica já, mude ou não o valor (0x03)
+    /**
+     * @brief Lê o sensor e só notifica se o valor andou mais do que a banda morta desde a última
+     * notificação, se cruzou um limite de valor_critico ou se passou o intervalo máximo.
+     * Chamado pelo agendador a cada intervalo mínimo.
+     * @return true se notificou.
+     */
+    bool notifyIfChanged();
     // Getters para os dados
     String getSensorId() const;
     String getCharacteristicUuid() const;
@@ -31,6 +55,11 @@ public:
     void readNow();
     long getSamplingPeriod() const;
     float getLastValue() const;
+    // Últimas amostras gravadas por sample(), servidas da RAM sem ler o flash
+    const SampleRingBuffer& getRecentSamples() const;
+    // Índice da característica BLE do sensor, atribuído por setupBLE() (-1 = sem característica)
+    void setBleSlot(int slot);
+    int getBleSlot() const;
     virtual void toConfigJson(JsonArray& array) {
         JsonObject obj = array.createNestedObject();
         obj["sensor_id"] = _sensor_id;
@@ -41,11 +70,18 @@ public:
         JsonObject crit = obj.createNestedObject("valor_critico");
         crit["min"] = _valorCriticoMin;
         crit["max"] = _valorCriticoMax;
+
+        JsonObject notifyCfg = obj.createNestedObject("notify");
+        notifyCfg["deadband"] = _notifyDeadband;
+        notifyCfg["min_interval_ms"] = _notifyMinIntervalMs;
+        notifyCfg["max_interval_ms"] = _notifyMaxIntervalMs;
     }
 
 protected:
     // Método de calibração que as classes filhas DEVEM implementar
     virtual void _configureCalibration(const JsonVariant& calibrationConfig) = 0;
+    // Sobreamostragem do ADC ("adc" no JSON do sensor); só os sensores analógicos a usam
+    virtual void _configureAdc(const JsonVariant& /*adcConfig*/) {}
 
     // Membros de dados (protegidos para que as classes filhas possam acedê-los)
     String _sensor_type;
@@ -59,7 +95,18 @@ protected:
     unsigned long _lastSampleMillis;
     float _lastValue;
     void notifyBLE(float value);
+    void _sendNotify(float value);
+    int8_t _criticalZone(float value) const; // -1 abaixo do mínimo, 1 acima do máximo, 0 dentro
     unsigned long _lastNotifyMillis = 0;
+    // Notificação por mudança ("notify" no JSON do sensor)
+    float _notifyDeadband = 0;
+    unsigned long _notifyMinIntervalMs = SENSOR_NOTIFY_PERIOD_MS;
+    unsigned long _notifyMaxIntervalMs = SENSOR_NOTIFY_MAX_INTERVAL_MS;
+    float _lastNotifiedValue = 0;
+    int8_t _lastNotifiedZone = 0;
+    bool _notifiedOnce = false;
+    int _bleSlot = -1;
+    SampleRingBuffer _recentSamples;
     RTCService rtcService;
 };
 
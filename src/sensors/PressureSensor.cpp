@@ -30,8 +30,19 @@ void PressureSensor::_configureCalibration(const JsonVariant& calibrationConfig)
                   _sensor_id.c_str(), _rangeMin, _rangeMax);
 }
 
+/**
+ * @brief Lê o objeto "adc" (opcional) com a sobreamostragem do pino.
+ */
+void PressureSensor::_configureAdc(const JsonVariant& adcConfig) {
+    _adc.configure(adcConfig);
+}
+
 int PressureSensor::getRaw(){
-    return analogRead(_pin);
+    return _adc.read(_pin);
+}
+
+int PressureSensor::getSampleRaw(){
+    return _adc.readFiltered(_pin);
 }
 /**
  * @brief Contém a lógica de hardware: ler o pino e aplicar a matemática.
@@ -2,6 +2,7 @@
 #define PRESSURE_SENSOR_H
 
 #include "BaseSensor.h" // Corrigido para "BaseSensor" (ou "Sensor", o que for o nome do seu arquivo base)
+#include "AnalogOversampler.h"
 
 class PressureSensor : public Sensor { // Corrigido para "BaseSensor"
 public:
@@ -20,11 +21,14 @@ protected:
      * @brief Configura os parâmetros de calibração para o sensor de pressão.
      */
     void _configureCalibration(const JsonVariant& calibrationConfig) override;
+    void _configureAdc(const JsonVariant& adcConfig) override;
 
     int getRaw() override;
+    int getSampleRaw() override;
 
 private:
     uint8_t _pin;
+    AnalogOversampler _adc; // rajada de leituras + mediana/média aparada e EMA opcional
 
     // --- Usando os nomes de variáveis que você definiu ---
     int _zero;
@@ -0,0 +1,55 @@
+#include "SampleRingBuffer.h"
+
+SampleRingBuffer::SampleRingBuffer() : _head(0), _count(0) {}
+
+void SampleRingBuffer::push(uint32_t timestamp, int32_t raw, float value) {
+    portENTER_CRITICAL(&_mux);
+    _samples[_head] = { timestamp, raw, value };
+    _head = (_head + 1) % SENSOR_RING_CAPACITY;
+    if (_count < SENSOR_RING_CAPACITY) _count++;
+    portEXIT_CRITICAL(&_mux);
+}
+
+size_t SampleRingBuffer::size() const {
+    return _count;
+}
+
+void SampleRingBuffer::clear() {
+    portENTER_CRITICAL(&_mux);
+    _head = 0;
+    _count = 0;
+    portEXIT_CRITICAL(&_mux);
+}
+
+size_t SampleRingBuffer::_indexOf(size_t i) const {
+    return (_head + SENSOR_RING_CAPACITY - _count + i) % SENSOR_RING_CAPACITY;
+}
+
+size_t SampleRingBuffer::copyLast(size_t lastN, SensorSample* out, size_t maxCount) const {
+    portENTER_CRITICAL(&_mux);
+    size_t n = min(min(lastN, _count), maxCount);
+    size_t first = _count - n;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = _samples[_indexOf(first + i)];
+    }
+    portEXIT_CRITICAL(&_mux);
+    return n;
+}
+
+size_t SampleRingBuffer::copySince(uint32_t since, SensorSample* out, size_t maxCount) const {
+    portENTER_CRITICAL(&_mux);
+    // As amostras estão por ordem de tempo: procura a primeira >= since a partir do fim
+    size_t first = _count;
+    while (first > 0 && _samples[_indexOf(first - 1)].timestamp >= since) first--;
+
+    size_t n = _count - first;
+    if (n > maxCount) {
+        first += n - maxCount;
+        n = maxCount;
+    }
+    for (size_t i = 0; i < n; i++) {
+        out[i] = _samples[_indexOf(first + i)];
+    }
+    portEXIT_CRITICAL(&_mux);
+    return n;
+}
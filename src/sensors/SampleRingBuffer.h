@@ -0,0 +1,53 @@
+#ifndef SAMPLE_RING_BUFFER_H
+#define SAMPLE_RING_BUFFER_H
+
+#include <Arduino.h>
+
+// Amostras recentes guardadas em RAM por sensor (12 bytes cada)
+#define SENSOR_RING_CAPACITY 64
+
+/**
+ * @brief Uma leitura guardada no buffer circular.
+ */
+struct SensorSample {
+    uint32_t timestamp;  // epoch em segundos
+    int32_t raw;
+    float value;
+};
+
+/**
+ * @brief Buffer circular de capacidade fixa, sem alocação dinâmica.
+ * Escrito pelo loop() (amostragem) e lido pelo servidor web/BLE noutras tarefas,
+ * por isso cada operação corre numa secção crítica curta.
+ */
+class SampleRingBuffer {
+public:
+    SampleRingBuffer();
+
+    void push(uint32_t timestamp, int32_t raw, float value);
+    size_t size() const;
+    void clear();
+
+    /**
+     * @brief Copia as últimas 'lastN' amostras, da mais antiga para a mais recente.
+     * @return Número de amostras escritas em 'out' (no máximo maxCount).
+     */
+    size_t copyLast(size_t lastN, SensorSample* out, size_t maxCount) const;
+
+    /**
+     * @brief Copia as amostras com timestamp >= since, da mais antiga para a mais recente.
+     * @return Número de amostras escritas em 'out' (no máximo maxCount, ficando as mais recentes).
+     */
+    size_t copySince(uint32_t since, SensorSample* out, size_t maxCount) const;
+
+private:
+    // Índice físico da i-ésima amostra mais antiga
+    size_t _indexOf(size_t i) const;
+
+    SensorSample _samples[SENSOR_RING_CAPACITY];
+    size_t _head;   // próxima posição a escrever
+    size_t _count;
+    mutable portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+};
+
+#endif
@@ -67,8 +67,19 @@ Serial.printf("-> TDS Faixa final: min=%.2f max=%.2f\n", _rangeMin, _rangeMax);
                   _rangeMax);
 }
 
+/**
+ * @brief Lê o objeto "adc" (opcional) com a sobreamostragem do pino.
+ */
+void TdsSensor::_configureAdc(const JsonVariant& adcConfig) {
+    _adc.configure(adcConfig);
+}
+
 int TdsSensor::getRaw(){
-    return analogRead(_pin);
+    return _adc.read(_pin);
+}
+
+int TdsSensor::getSampleRaw(){
+    return _adc.readFiltered(_pin);
 }
 /**
  * @brief Contém a lógica de hardware: ler o pino e aplicar a matemática.
@@ -2,6 +2,7 @@
 #define TDS_SENSOR_H
 
 #include "BaseSensor.h" // Inclui a definição da classe mãe
+#include "AnalogOversampler.h"
 #include <vector>
 // SoilMoistureSensor "é um" Sensor
 class TdsSensor : public Sensor {
@@ -18,6 +19,7 @@ public:
      */
     float getValue(int rawValue) override;
     int getRaw() override;
+    int getSampleRaw() override;
 
    
 
@@ -28,12 +30,14 @@ protected:
      * @param calibrationConfig O objeto JSON "calibration" do arquivo de configuração.
      */
     void _configureCalibration(const JsonVariant& calibrationConfig) override;
+    void _configureAdc(const JsonVariant& adcConfig) override;
 
 private:
     // --- Membros Privados Específicos Deste Sensor ---
 
     // Pino onde o sensor está conectado
     uint8_t _pin;
+    AnalogOversampler _adc; // rajada de leituras + mediana/média aparada e EMA opcional
 
     String _calibrationType;
     float _a, _b;                     // linear
@@ -2,7 +2,9 @@
 
 TemperatureSensor::TemperatureSensor(uint8_t pin)
     : _pin(pin), _oneWire(nullptr), _sensors(nullptr), _index(0),
-      _rangeMin(-50.0f), _rangeMax(125.0f)
+      _rangeMin(-50.0f), _rangeMax(125.0f),
+      _asyncConversion(true), _resolution(12), _conversionTimeMs(750),
+      _conversionStartMillis(0), _conversionPending(false), _cachedTemp(0.0f)
 {
     // O pino é configurado dentro do OneWire/Dallas
 }
@@ -15,13 +17,66 @@ void TemperatureSensor::_configureCalibration(const JsonVariant& calibrationConf
     _rangeMin = calibrationConfig["valid_range"]["min"] | -50.0f;
     _rangeMax = calibrationConfig["valid_range"]["max"] | 125.0f;
 
+    _resolution = constrain((int)(calibrationConfig["resolution"] | 12), 9, 12);
+    _asyncConversion = calibrationConfig["async_conversion"] | true;
+
     // Inicializa biblioteca DallasTemperature
     _oneWire = new OneWire(_pin);
     _sensors = new DallasTemperature(_oneWire);
     _sensors->begin();
+    _sensors->setResolution(_resolution);
+    _conversionTimeMs = _sensors->millisToWaitForConversion(_resolution);
+
+    // Primeira leitura bloqueante ainda no setup, para a cache nunca começar vazia
+    _sensors->setWaitForConversion(true);
+    _sensors->requestTemperatures();
+    _updateCache(_readTemperature());
+
+    if (_asyncConversion) {
+        _sensors->setWaitForConversion(false);
+        _startConversion();
+    }
 
-    Serial.printf(" Temperatura -> Sensor DS18B20 (ID: %s) configurado: unidade=%s, índice=%d, range=[%.1f, %.1f]\n",
-                  _sensor_id.c_str(), _unit.c_str(), _index, _rangeMin, _rangeMax);
+    Serial.printf(" Temperatura -> Sensor DS18B20 (ID: %s) configurado: unidade=%s, índice=%d, range=[%.1f, %.1f], %u bits, %s\n",
+                  _sensor_id.c_str(), _unit.c_str(), _index, _rangeMin, _rangeMax, _resolution,
+                  _asyncConversion ? "assíncrono" : "bloqueante");
+}
+
+// ----------------------- Conversão assíncrona -----------------------
+void TemperatureSensor::_startConversion() {
+    _sensors->requestTemperatures(); // com setWaitForConversion(false) só envia o comando
+    _conversionStartMillis = millis();
+    _conversionPending = true;
+}
+
+void TemperatureSensor::_harvestConversion() {
+    if (!_conversionPending) return;
+    if (millis() - _conversionStartMillis < _conversionTimeMs) return; // ainda a converter
+
+    _conversionPending = false;
+    _updateCache(_readTemperature());
+}
+
+// Guarda a leitura (NAN incluído, para o lado de cima ver a sonda perdida) e
+// só avisa na transição, não a cada leitura falhada
+void TemperatureSensor::_updateCache(float temp) {
+    if (isnan(temp) && !isnan(_cachedTemp)) {
+        Serial.printf("⚠️ DS18B20 (ID: %s) sem resposta, a reportar NaN\n", _sensor_id.c_str());
+    } else if (!isnan(temp) && isnan(_cachedTemp)) {
+        Serial.printf("✅ DS18B20 (ID: %s) voltou a responder\n", _sensor_id.c_str());
+    }
+    _cachedTemp = temp;
+}
+
+// Lê o scratchpad e aplica os limites; NAN se o sensor não respondeu
+float TemperatureSensor::_readTemperature() {
+    float temp = _sensors->getTempCByIndex(_index);
+    if (temp == DEVICE_DISCONNECTED_C) return NAN;
+
+    // Limita aos valores mínimos/máximos definidos
+    if (temp < _rangeMin) temp = _rangeMin;
+    if (temp > _rangeMax) temp = _rangeMax;
+    return temp;
 }
 
 // ----------------------- Raw -----------------------
@@ -31,15 +86,19 @@ int TemperatureSensor::getRaw() {
 }
 
 // ----------------------- Valor calibrado -----------------------
+// Nunca bloqueia no modo assíncrono: devolve a última conversão concluída e
+// arranca a seguinte, que fica pronta para a próxima chamada.
 float TemperatureSensor::getValue(int rawValue) {
     if (!_sensors) return 0.0f;
 
-    _sensors->requestTemperatures();
-    float temp = _sensors->getTempCByIndex(_index);
+    if (!_asyncConversion) {
+        _sensors->requestTemperatures(); // bloqueia até _conversionTimeMs
+        _updateCache(_readTemperature());
+        return _cachedTemp;
+    }
 
-    // Limita aos valores mínimos/máximos definidos
-    if (temp < _rangeMin) temp = _rangeMin;
-    if (temp > _rangeMax) temp = _rangeMax;
+    _harvestConversion();
+    if (!_conversionPending) _startConversion();
     //temp = random(100, 300)/10;
-    return temp;
+    return _cachedTemp;
 }
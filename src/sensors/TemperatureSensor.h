@@ -16,6 +16,15 @@ protected:
     void _configureCalibration(const JsonVariant& calibrationConfig) override;
 
 private:
+    /**
+     * @brief Conversão em duas fases: _startConversion() pede a medição e volta logo;
+     * _harvestConversion() lê o resultado quando o tempo de conversão já passou.
+     */
+    void _startConversion();
+    void _harvestConversion();
+    float _readTemperature();
+    void _updateCache(float temp);
+
     uint8_t _pin;
 
     OneWire* _oneWire;
@@ -24,6 +33,13 @@ private:
 
     float _rangeMin;
     float _rangeMax;
+
+    bool _asyncConversion;
+    uint8_t _resolution;              // 9 a 12 bits (94 a 750 ms de conversão)
+    unsigned long _conversionTimeMs;
+    unsigned long _conversionStartMillis;
+    bool _conversionPending;
+    float _cachedTemp;                // última conversão concluída (NAN se a sonda não respondeu)
 };
 
 #endif
@@ -26,32 +26,33 @@ float VolumeSensor::getValue(int rawValue) {
     return _accumulatedVolume;
 }
 
-// ----------------------- Update -----------------------
-void VolumeSensor::update(){
-    // Chama update do FlowSensor implicitamente pelo getValue
+// ----------------------- Amostragem -----------------------
+void VolumeSensor::sample(){
+    // Chamado pelo agendador a cada _sampling_period_sec
     time_t current_ts = rtcService.getTimestamp(); 
 
+    _lastSampleMillis = millis();
+    int pulses = _flowSensor->getRaw();
+    float flowLPerMin = _flowSensor->getValue(pulses);
+
+    // Converte fluxo instantâneo para volume acumulado no período de amostragem
+    // volume = fluxo (L/min) * tempo (min)
+    float deltaTimeMin = _sampling_period_sec / 60.0f; 
+    _accumulatedVolume += flowLPerMin * deltaTimeMin;
+
+    // Limita ao intervalo definido
+    if (_accumulatedVolume < _rangeMin) _accumulatedVolume = _rangeMin;
+    if (_accumulatedVolume > _rangeMax) _accumulatedVolume = _rangeMax;
+    _lastValue = _accumulatedVolume;
+
+    // Notifica e registra leitura
+    _recentSamples.push((uint32_t)current_ts, 0, _accumulatedVolume);
+    notifySensorValue(_bleSlot, _accumulatedVolume);
+    logSensorReading(current_ts,_sensor_id, _sensor_type,_unit, 0, _accumulatedVolume); 
+    Serial.println("Hora de salvar. 2");
+}
 
-    unsigned long currentMillis = millis();
-    if (currentMillis - _lastSampleMillis >= (_sampling_period_sec * 1000L)) {
-        _lastSampleMillis = currentMillis;
-        int pulses = _flowSensor->getRaw();
-        float flowLPerMin = _flowSensor->getValue(pulses);
-
-        // Converte fluxo instantâneo para volume acumulado no período de amostragem
-        // volume = fluxo (L/min) * tempo (min)
-        float deltaTimeMin = _sampling_period_sec / 60.0f; 
-        _accumulatedVolume += flowLPerMin * deltaTimeMin;
-
-        // Limita ao intervalo definido
-        if (_accumulatedVolume < _rangeMin) _accumulatedVolume = _rangeMin;
-        if (_accumulatedVolume > _rangeMax) _accumulatedVolume = _rangeMax;
-
-        // Notifica e registra leitura
-        notifySensorValue(_sensor_id, _accumulatedVolume, _unit);
-        logSensorReading(current_ts,_sensor_id, _sensor_type,_unit, 0, _accumulatedVolume); 
-         Serial.println("Hora de salvar. 2");
-
-    }
-   
+// O volume só muda a cada amostragem, que já notifica: não há cadência de notificação própria
+unsigned long VolumeSensor::getNotifyPeriodMs() const {
+    return 0;
 }
@@ -10,7 +10,8 @@ public:
 
     int getRaw() override;
     float getValue(int rawValue) override;
-    void update() override;
+    void sample() override;
+    unsigned long getNotifyPeriodMs() const override;
 
 protected:
     void _configureCalibration(const JsonVariant& calibrationConfig) override;
@@ -0,0 +1,233 @@
+#include "sync_watermark.h"
+#include <LittleFS.h>
+#include <ArduinoJson.h>
+
+static volatile uint32_t _generation = 0;
+
+SyncWatermark::SyncWatermark() : day(0) {}
+
+const SyncFileMark* SyncWatermark::find(uint32_t fileDay, const String& fileName) const {
+    for (const SyncFileMark& mark : files) {
+        if (mark.day == fileDay && mark.name == fileName) return &mark;
+    }
+    return nullptr;
+}
+
+static String _markName(const LogCatalogEntry& entry) {
+    return logUncompressedName(logCatalogFileName(entry));
+}
+
+// Formato: {"<cliente>": {"t": último sync, "d": dia, "f": [[dia, nome, registos, posição, compactação], ...]}}
+static bool _loadState(JsonDocument& doc) {
+    File in = LittleFS.open(SYNC_STATE_PATH, "r");
+    if (!in) return false;
+    DeserializationError error = deserializeJson(doc, in);
+    in.close();
+    if (error) doc.clear();
+    return !error;
+}
+
+// Temporário e rename, como os manifestos: uma falha de energia não deixa o ficheiro truncado
+static bool _saveState(const JsonDocument& doc) {
+    String tmpPath = String(SYNC_STATE_PATH) + ".tmp";
+    File out = LittleFS.open(tmpPath, "w");
+    if (!out) return false;
+    serializeJson(doc, out);
+    out.close();
+    return LittleFS.rename(tmpPath, SYNC_STATE_PATH);
+}
+
+bool loadSyncWatermark(const String& clientId, SyncWatermark& mark) {
+    mark = SyncWatermark();
+    LogReadLock lock; // o logger reescreve as marcas quando agrega ou apaga um dia
+    DynamicJsonDocument doc(SYNC_STATE_DOC_SIZE);
+    if (!_loadState(doc)) return false;
+
+    JsonObject client = doc[clientId];
+    if (client.isNull()) return false;
+    mark.day = client["d"] | 0u;
+    for (JsonArray f : client["f"].as<JsonArray>()) {
+        SyncFileMark fileMark = { f[0].as<uint32_t>(), String(f[1].as<const char*>()), f[2].as<uint32_t>(),
+                                  f[3].as<uint32_t>(), (LogCompression)f[4].as<uint8_t>() };
+        mark.files.push_back(fileMark);
+    }
+    return true;
+}
+
+bool saveSyncWatermark(const String& clientId, const SyncWatermark& mark) {
+    LogReadLock lock;
+    DynamicJsonDocument doc(SYNC_STATE_DOC_SIZE);
+    _loadState(doc);
+    doc.remove(clientId);
+
+    // Sem lugar: sai o cliente há mais tempo sem sync
+    while (doc.size() >= SYNC_MAX_CLIENTS) {
+        String oldest;
+        uint32_t oldestTs = UINT32_MAX;
+        for (JsonPair kv : doc.as<JsonObject>()) {
+            uint32_t ts = kv.value()["t"] | 0u;
+            if (ts < oldestTs) {
+                oldestTs = ts;
+                oldest = kv.key().c_str();
+            }
+        }
+        doc.remove(oldest);
+    }
+
+    JsonObject client = doc.createNestedObject(clientId);
+    client["t"] = (uint32_t)time(nullptr);
+    client["d"] = mark.day;
+    JsonArray files = client.createNestedArray("f");
+    for (const SyncFileMark& fileMark : mark.files) {
+        JsonArray f = files.createNestedArray();
+        f.add(fileMark.day);
+        f.add(fileMark.name);
+        f.add(fileMark.records);
+        f.add(fileMark.position);
+        f.add((uint8_t)fileMark.compression);
+    }
+    if (doc.overflowed()) {
+        Serial.printf("⚠️ Marca de sync de %s não cabe em %u bytes.\n", clientId.c_str(), (unsigned)SYNC_STATE_DOC_SIZE);
+        return false;
+    }
+
+    return _saveState(doc);
+}
+
+void clearSyncWatermarks() {
+    _generation = _generation + 1;
+    LittleFS.remove(SYNC_STATE_PATH);
+}
+
+uint32_t syncWatermarkGeneration() {
+    return _generation;
+}
+
+void remapSyncFileMarks(const LogCatalogEntry& entry, const std::vector<uint32_t>& sourceEnds) {
+    LogReadLock lock;
+    DynamicJsonDocument doc(SYNC_STATE_DOC_SIZE);
+    if (!_loadState(doc)) return;
+
+    String name = _markName(entry);
+    bool changed = false;
+    for (JsonPair kv : doc.as<JsonObject>()) {
+        for (JsonArray f : kv.value()["f"].as<JsonArray>()) {
+            if (f[0].as<uint32_t>() != entry.day || name != f[1].as<const char*>()) continue;
+            // Só conta como confirmado o registo novo cujos registos de origem foram todos confirmados
+            uint32_t acked = f[2].as<uint32_t>();
+            uint32_t records = 0;
+            while (records < sourceEnds.size() && sourceEnds[records] <= acked) records++;
+            f[2] = records;
+            f[3] = 0; // posição desconhecida no ficheiro novo: o sync conta os registos
+            f[4] = (uint8_t)LogCompression::NONE;
+            changed = true;
+        }
+    }
+    if (!changed) return;
+    _generation = _generation + 1; // um sync em curso planeou sobre o ficheiro antigo
+    if (!_saveState(doc)) Serial.println("⚠️ Falha ao regravar as marcas de sync depois da agregação.");
+}
+
+void dropSyncDayMarks(uint32_t day) {
+    LogReadLock lock;
+    DynamicJsonDocument doc(SYNC_STATE_DOC_SIZE);
+    if (!_loadState(doc)) return;
+
+    bool changed = false;
+    for (JsonPair kv : doc.as<JsonObject>()) {
+        JsonArray files = kv.value()["f"].as<JsonArray>();
+        for (size_t i = files.size(); i-- > 0;) {
+            if (files[i][0].as<uint32_t>() != day) continue;
+            files.remove(i);
+            changed = true;
+        }
+    }
+    if (changed) _saveState(doc);
+}
+
+static SyncFilePlan _planFile(const LogCatalogEntry& entry, uint32_t startRecords, const SyncFileMark* mark) {
+    SyncFilePlan file;
+    file.entry = entry;
+    file.path = logCatalogPath(entry);
+    file.startRecords = startRecords;
+    file.mark = mark;
+    file.openedCompression = entry.compression;
+    file.ackedRecords = startRecords;
+    file.ackedPosition = mark ? mark->position : 0;
+    file.eof = false;
+    file.eofSeq = 0;
+    file.eofPosition = 0;
+    return file;
+}
+
+std::vector<SyncFilePlan> planSyncDelta(const SyncWatermark& mark, uint32_t& pendingRecords) {
+    std::vector<SyncFilePlan> plan;
+    pendingRecords = 0;
+    std::vector<LogCatalogEntry> entries = findLogCatalogEntries(String(), 0, 0);
+    uint32_t openDay = entries.empty() ? 0 : entries.back().day; // o dia em escrita continua a crescer
+
+    for (const LogCatalogEntry& entry : entries) {
+        if (entry.day < mark.day) continue;
+        const SyncFileMark* fileMark = mark.find(entry.day, _markName(entry));
+        uint32_t start = fileMark ? fileMark->records : 0;
+        if (start >= entry.records && entry.day < openDay) continue; // dia fechado já confirmado
+        pendingRecords += entry.records > start ? entry.records - start : 0;
+        plan.push_back(_planFile(entry, start, fileMark));
+    }
+    return plan;
+}
+
+std::vector<SyncFilePlan> planSyncRange(time_t since, time_t until) {
+    std::vector<SyncFilePlan> plan;
+    for (const LogCatalogEntry& entry : findLogCatalogEntries(String(), since, until)) {
+        plan.push_back(_planFile(entry, 0, nullptr));
+    }
+    return plan;
+}
+
+void advanceSyncWatermark(SyncWatermark& mark, const std::vector<SyncFilePlan>& plan, uint32_t ackedSeq) {
+    std::vector<SyncFileMark> updates;
+    for (const SyncFilePlan& file : plan) {
+        SyncFileMark fileMark = { file.entry.day, _markName(file.entry), file.ackedRecords, file.ackedPosition,
+                                  file.openedCompression };
+        if (file.eof && ackedSeq >= file.eofSeq) {
+            // Confirmado até ao fim: vale a contagem do catálogo (inclui registos .bin com CRC inválido, que não são enviados)
+            if (file.entry.records > fileMark.records) fileMark.records = file.entry.records;
+            fileMark.position = file.eofPosition;
+        } else if (file.ackedRecords <= file.startRecords) {
+            continue; // nada de novo confirmado
+        }
+        updates.push_back(fileMark);
+    }
+
+    for (const SyncFileMark& update : updates) {
+        bool found = false;
+        for (SyncFileMark& fileMark : mark.files) {
+            if (fileMark.day == update.day && fileMark.name == update.name) {
+                fileMark = update;
+                found = true;
+            }
+        }
+        if (!found) mark.files.push_back(update);
+    }
+
+    // 'day' avança até ao primeiro dia fechado com um ficheiro por confirmar (no máximo até ao dia em escrita)
+    std::vector<LogCatalogEntry> entries = findLogCatalogEntries(String(), 0, 0);
+    uint32_t day = entries.empty() ? mark.day : entries.back().day;
+    for (const LogCatalogEntry& entry : entries) {
+        if (entry.day >= day) break;
+        if (entry.day < mark.day) continue;
+        const SyncFileMark* fileMark = mark.find(entry.day, _markName(entry));
+        if ((fileMark ? fileMark->records : 0) < entry.records) {
+            day = entry.day;
+            break;
+        }
+    }
+    if (day > mark.day) mark.day = day;
+
+    std::vector<SyncFileMark> kept;
+    for (const SyncFileMark& fileMark : mark.files) {
+        if (fileMark.day >= mark.day) kept.push_back(fileMark);
+    }
+    mark.files = kept;
+}
@@ -0,0 +1,79 @@
+#ifndef SYNC_WATERMARK_H
+#define SYNC_WATERMARK_H
+
+#include <Arduino.h>
+#include <vector>
+#include "data_logger.h"
+
+// Marcas de sync de cada cliente BLE, gravadas no LittleFS
+#define SYNC_STATE_PATH "/sync_state.json"
+#define SYNC_STATE_DOC_SIZE 3072
+#define SYNC_MAX_CLIENTS 4 // o cliente há mais tempo sem sincronizar sai primeiro
+
+/**
+ * @brief Até onde um ficheiro de log já foi confirmado por um cliente.
+ * Conta registos (não bytes), para continuar a valer depois da compactação do dia.
+ */
+struct SyncFileMark {
+    uint32_t day;       // AAAAMMDD
+    String name;        // nome sem a extensão da compactação (<sensorId>.jsonl ou .bin)
+    uint32_t records;   // registos confirmados desde o início do ficheiro
+    uint32_t position;  // LogFileReader::position() depois do último confirmado (0 = desconhecida: conta os registos)
+    LogCompression compression; // 'position' só vale enquanto o ficheiro estiver nesta forma
+};
+
+/**
+ * @brief Marca de sync de um cliente: tudo antes de 'day' está confirmado;
+ * dali em diante, a marca de cada ficheiro.
+ */
+struct SyncWatermark {
+    uint32_t day;
+    std::vector<SyncFileMark> files;
+
+    SyncWatermark();
+    const SyncFileMark* find(uint32_t fileDay, const String& fileName) const;
+};
+
+/**
+ * @brief Ficheiro de um sync: item do catálogo, onde começa o que falta enviar
+ * e, durante o envio, até onde o cliente já confirmou.
+ */
+struct SyncFilePlan {
+    LogCatalogEntry entry;
+    String path;
+    uint32_t startRecords;  // registos já confirmados (saltados ao abrir)
+    const SyncFileMark* mark;
+    LogCompression openedCompression; // forma do ficheiro quando foi aberto para enviar
+
+    uint32_t ackedRecords;
+    uint32_t ackedPosition;
+    bool eof;               // lido até ao fim ...
+    uint32_t eofSeq;        // ... e o último registo enviado tinha este seq
+    uint32_t eofPosition;
+};
+
+// Marca guardada do cliente; false = cliente sem sync confirmado (tudo por enviar)
+bool loadSyncWatermark(const String& clientId, SyncWatermark& mark);
+bool saveSyncWatermark(const String& clientId, const SyncWatermark& mark);
+
+// Apaga as marcas de todos os clientes (o histórico foi apagado: as contagens deixaram de valer)
+void clearSyncWatermarks();
+uint32_t syncWatermarkGeneration(); // muda a cada clearSyncWatermarks(), para um sync em curso não regravar marcas velhas
+
+/**
+ * @brief O ficheiro de um dia fechado foi agregado: as marcas de todos os clientes passam a contar registos do
+ * ficheiro novo. sourceEnds[i] = registos do ficheiro antigo até ao fim do registo novo i. Muda a geração.
+ */
+void remapSyncFileMarks(const LogCatalogEntry& entry, const std::vector<uint32_t>& sourceEnds);
+// O dia foi apagado: as marcas dos seus ficheiros deixam de valer
+void dropSyncDayMarks(uint32_t day);
+
+// Ficheiros com registos por confirmar, em ordem cronológica, e quantos registos faltam
+std::vector<SyncFilePlan> planSyncDelta(const SyncWatermark& mark, uint32_t& pendingRecords);
+// Ficheiros com registos em [since, until], todos desde o início (sync por intervalo)
+std::vector<SyncFilePlan> planSyncRange(time_t since, time_t until);
+
+// Junta à marca o que o sync confirmou e avança 'day' sobre os dias fechados já completos
+void advanceSyncWatermark(SyncWatermark& mark, const std::vector<SyncFilePlan>& plan, uint32_t ackedSeq);
+
+#endif
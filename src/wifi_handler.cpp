@@ -5,6 +5,7 @@
 //#include <ESPAsyncWebServer.h>
 #include <ArduinoJson.h>
 #include <LittleFS.h>
+#include <memory>
 #include "data_logger.h"
 #include "time.h"
 #include "hub_config.h"
@@ -21,6 +22,9 @@ AsyncWebServer server(80);
 // tamanho seguro do chunk
 #define LINES_PER_PAGE 50
 #define BUFFER_SIZE 256
+// Agregados por resposta do /agregados (~110 bytes de JsonDocument cada)
+#define ROLLUPS_PER_PAGE 128
+#define ROLLUPS_MAX_PAGE 256
 
 struct StreamState {
   File root;
@@ -53,91 +57,367 @@ String escapeJSON(const String& input) {
 }
 
 
-void enviarArquivoInteiro(AsyncWebServerRequest *request, const String& arquivo, int page, int totalArquivos) {
-    File file = LittleFS.open(arquivo, "r");
-    if (!file) {
+// --- ETag e Range nos downloads de logs ---
+// Os logs só crescem: tamanho + data da última escrita identificam o conteúdo de um ficheiro.
+
+static String logFileETag(size_t size, time_t lastWrite, const char* suffix = "") {
+    char etag[64];
+    snprintf(etag, sizeof(etag), "\"%x-%lx%s\"", (unsigned)size, (unsigned long)lastWrite, suffix);
+    return String(etag);
+}
+
+// If-None-Match: "*" ou lista de ETags separadas por vírgula (com ou sem W/)
+static bool etagMatches(AsyncWebServerRequest *request, const String& etag) {
+    if (!request->hasHeader("If-None-Match")) return false;
+    String value = request->getHeader("If-None-Match")->value();
+    value.trim();
+    return value == "*" || value.indexOf(etag) != -1;
+}
+
+static void enviarNaoModificado(AsyncWebServerRequest *request, const String& etag) {
+    AsyncWebServerResponse *response = request->beginResponse(304);
+    response->addHeader("ETag", etag);
+    request->send(response);
+}
+
+static bool isDecimal(const String& text) {
+    if (text.length() == 0) return false;
+    for (size_t i = 0; i < text.length(); i++) {
+        if (!isdigit((unsigned char)text[i])) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Interpreta "Range: bytes=a-b", "bytes=a-" ou "bytes=-n" sobre um ficheiro de 'size' bytes.
+ * Vários intervalos, sintaxe inválida ou If-Range de outra versão são ignorados (resposta inteira).
+ * @return 1 com [start, end] preenchido, 0 sem Range, -1 se o intervalo não for satisfazível (416).
+ */
+static int parseByteRange(AsyncWebServerRequest *request, const String& etag, size_t size, size_t& start, size_t& end) {
+    if (!request->hasHeader("Range")) return 0;
+    if (request->hasHeader("If-Range") && request->getHeader("If-Range")->value() != etag) return 0;
+
+    String value = request->getHeader("Range")->value();
+    value.trim();
+    int dash = value.indexOf('-');
+    if (!value.startsWith("bytes=") || value.indexOf(',') != -1 || dash < 0) return 0;
+
+    String first = value.substring(6, dash);
+    String last = value.substring(dash + 1);
+    first.trim();
+    last.trim();
+
+    if (first.length() == 0) {
+        // Sufixo: os últimos N bytes
+        if (!isDecimal(last)) return 0;
+        size_t suffix = strtoul(last.c_str(), nullptr, 10);
+        if (suffix == 0 || size == 0) return -1;
+        start = size > suffix ? size - suffix : 0;
+        end = size - 1;
+        return 1;
+    }
+
+    if (!isDecimal(first) || (last.length() > 0 && !isDecimal(last))) return 0;
+    start = strtoul(first.c_str(), nullptr, 10);
+    end = last.length() > 0 ? strtoul(last.c_str(), nullptr, 10) : SIZE_MAX;
+    if (end < start) return 0;
+    if (start >= size) return -1;
+    if (end >= size) end = size - 1;
+    return 1;
+}
+
+// Accept-Encoding com gzip (e sem q=0)
+static bool aceitaGzip(AsyncWebServerRequest *request) {
+    if (!request->hasHeader("Accept-Encoding")) return false;
+    String value = request->getHeader("Accept-Encoding")->value();
+    value.toLowerCase();
+    int pos = value.indexOf("gzip");
+    if (pos < 0) return false;
+    int end = value.indexOf(',', pos);
+    String item = value.substring(pos, end < 0 ? value.length() : end);
+    int q = item.indexOf("q=");
+    return q == -1 || item.substring(q + 2).toFloat() > 0;
+}
+
+/**
+ * @brief Estado do envio de um dia compactado em colunas (um por pedido, partilhado com o callback).
+ */
+struct ColunarExport {
+    LogFileReader reader;
+    char pending[LOG_LINE_MAX + 2]; // linha + "\r\n"
+    size_t pendingLen;
+    size_t pendingPos;
+};
+
+/**
+ * @brief O .col não serve a clientes HTTP: vai decodificado em NDJSON (num .jsonl.col, os mesmos bytes
+ * do ficheiro original), em chunks e sem Range, já que o tamanho só se sabe no fim.
+ */
+static void enviarArquivoColunar(AsyncWebServerRequest *request, const String& caminho) {
+    std::shared_ptr<ColunarExport> st = std::make_shared<ColunarExport>();
+    st->pendingLen = 0;
+    st->pendingPos = 0;
+    if (!st->reader.open(caminho)) {
         request->send(404, "application/json", "{\"erro\":\"Arquivo não encontrado\"}");
         return;
     }
 
-    Serial.printf("Enviando arquivo completo: %s, Tamanho: %d bytes\n", arquivo.c_str(), file.size());
-
-    // Usa variáveis estáticas para manter o estado entre chunks
-    static bool headerSent = false;
-    static bool inLinesArray = false;
-    static int lineCount = 0;
-    static File currentFile;
-
-    // Reseta as variáveis estáticas para nova requisição
-    headerSent = false;
-    inLinesArray = false;
-    lineCount = 0;
-    currentFile = file;
-
-    AsyncWebServerResponse *response = request->beginChunkedResponse("application/json", 
-        [page, totalArquivos, arquivo](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
-            
-            // Primeiro chunk: envia o cabeçalho
-            if (!headerSent) {
-                String header = "{\"pagina_atual\":" + String(page) + 
-                               ",\"total_arquivos\":" + String(totalArquivos) +
-                               ",\"arquivo\":\"" + arquivo + 
-                               "\",\"tamanho\":" + String(currentFile.size()) + 
-                               ",\"linhas\":[";
-                size_t headerLen = header.length();
-                if (headerLen <= maxLen) {
-                    memcpy(buffer, header.c_str(), headerLen);
-                    headerSent = true;
-                    inLinesArray = true;
-                    return headerLen;
+    String etag = logFileETag(st->reader.size(), st->reader.lastWrite(), "-nd");
+    if (etagMatches(request, etag)) {
+        enviarNaoModificado(request, etag);
+        return;
+    }
+
+    AsyncWebServerResponse *response = request->beginChunkedResponse("application/x-ndjson",
+        [st](uint8_t *buffer, size_t maxLen, size_t /*index*/) -> size_t {
+            LogReadLock lock;
+            size_t written = 0;
+            while (written < maxLen) {
+                if (st->pendingPos < st->pendingLen) {
+                    size_t n = std::min(st->pendingLen - st->pendingPos, maxLen - written);
+                    memcpy(buffer + written, st->pending + st->pendingPos, n);
+                    st->pendingPos += n;
+                    written += n;
+                    continue;
                 }
+                size_t len = st->reader.readNextLine(st->pending, LOG_LINE_MAX);
+                if (len == 0) break;
+                st->pending[len++] = '\r'; // mesmo terminador das linhas gravadas
+                st->pending[len++] = '\n';
+                st->pendingLen = len;
+                st->pendingPos = 0;
             }
-            
-            // Chunks intermediários: envia as linhas
-            if (inLinesArray && currentFile.available()) {
-                String linha = currentFile.readStringUntil('\n');
-                linha.trim();
-                
-                if (linha != "") {
-                    // CORREÇÃO: Usar método correto para construir a string
-                    String jsonLine;
-                    if (lineCount > 0) {
-                        jsonLine = ",";
-                    }
-                      if (linha.startsWith("{")) {
-                        jsonLine += linha;  // Já é JSON, usa diretamente
-                    } else {
-                        jsonLine += "\"" + escapeJSON(linha) + "\"";  // Não é JSON, escapa
-                    }
-                    
-                    lineCount++;
-                    
-                    if (jsonLine.length() <= maxLen) {
-                        memcpy(buffer, jsonLine.c_str(), jsonLine.length());
-                        return jsonLine.length();
-                    }
-                }
-                return 0;
+            return written;
+        }
+    );
+    response->addHeader("ETag", etag);
+    response->addHeader("Accept-Ranges", "none");
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+}
+
+/**
+ * @brief Envia o ficheiro de log tal como está no flash (.jsonl, .bin ou .gz de um dia compactado),
+ * com ETag e Range, para o cliente saltar ficheiros que já tem e retomar downloads interrompidos.
+ * O .gz vai com Content-Encoding: gzip; a clientes sem gzip vai descomprimido durante o envio.
+ */
+static void enviarArquivoBruto(AsyncWebServerRequest *request, const String& arquivo) {
+    // Grava o buffer de escrita para o arquivo do dia sair completo
+    flushLogs();
+
+    // Caminho de antes da compactação do dia (listagem guardada pelo cliente)
+    String caminho = resolveLogFilePath(arquivo);
+    if (isColumnarLogFileName(caminho)) {
+        enviarArquivoColunar(request, caminho);
+        return;
+    }
+    bool gzip = isCompressedLogFileName(caminho);
+    bool descomprimir = gzip && !aceitaGzip(request);
+
+    File file;
+    std::shared_ptr<LogGzipReader> inflater;
+    size_t size = 0;
+    time_t lastWrite = 0;
+    if (descomprimir) {
+        inflater = std::make_shared<LogGzipReader>();
+        if (inflater->open(caminho)) {
+            size = inflater->size();
+            lastWrite = inflater->lastWrite();
+        } else {
+            inflater.reset();
+        }
+    } else {
+        file = LittleFS.open(caminho, "r");
+        if (file && !file.isDirectory()) {
+            size = file.size();
+            lastWrite = file.getLastWrite();
+        } else {
+            file = File();
+        }
+    }
+    if (!file && !inflater) {
+        request->send(404, "application/json", "{\"erro\":\"Arquivo não encontrado\"}");
+        return;
+    }
+
+    // A versão descomprimida é outra representação: ETag própria
+    String etag = logFileETag(size, lastWrite, descomprimir ? "-id" : "");
+    if (etagMatches(request, etag)) {
+        enviarNaoModificado(request, etag);
+        return;
+    }
+
+    size_t start = 0;
+    size_t end = size > 0 ? size - 1 : 0;
+    int range = parseByteRange(request, etag, size, start, end);
+    if (range < 0) {
+        AsyncWebServerResponse *response = request->beginResponse(416);
+        response->addHeader("Content-Range", "bytes */" + String((unsigned long)size));
+        request->send(response);
+        return;
+    }
+
+    size_t length = size > 0 ? end - start + 1 : 0;
+    const char* contentType = logUncompressedName(caminho).endsWith(LOG_BIN_EXT) ? "application/octet-stream" : "application/x-ndjson";
+    // Enquanto o download durar, a compactação não troca o ficheiro por baixo
+    std::shared_ptr<LogFileUse> use = std::make_shared<LogFileUse>();
+    AsyncWebServerResponse *response = request->beginResponse(contentType, length,
+        [file, inflater, use, start, length](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t {
+            if (index >= length) return 0;
+            size_t n = std::min(maxLen, length - index);
+            // O logger pode estar a acrescentar a este ficheiro
+            LogReadLock lock;
+            if (inflater) return inflater->seek(start + index) ? inflater->read(buffer, n) : 0;
+            if (!file.seek(start + index)) return 0;
+            return file.read(buffer, n);
+        }
+    );
+    if (range > 0) {
+        response->setCode(206);
+        response->addHeader("Content-Range", "bytes " + String((unsigned long)start) + "-" +
+                            String((unsigned long)end) + "/" + String((unsigned long)size));
+    }
+    if (gzip) {
+        if (!descomprimir) response->addHeader("Content-Encoding", "gzip");
+        response->addHeader("Vary", "Accept-Encoding");
+    }
+    response->addHeader("ETag", etag);
+    response->addHeader("Accept-Ranges", "bytes");
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+}
+
+/**
+ * @brief Estado de uma exportação de /historico. Cada pedido tem o seu (partilhado com o
+ * callback da resposta), por isso pedidos simultâneos não se atropelam.
+ */
+struct HistoricoExport {
+    enum Stage : uint8_t { HEADER, LINES, FOOTER, DONE };
+
+    LogFileReader reader; // decodifica .bin para JSON na borda
+    String arquivo;
+    int page;
+    int totalArquivos;
+    size_t fileSize;
+    int lineCount;
+    Stage stage;
+
+    // Texto que não coube no buffer da chamada anterior (cabeçalho, linha ou rodapé)
+    char pending[2 * LOG_LINE_MAX + 4];
+    size_t pendingLen;
+    size_t pendingPos;
+};
+
+/**
+ * @brief Enche o buffer da resposta até maxLen: cabeçalho, linhas separadas por vírgula e rodapé.
+ * Quando uma linha inteira cabe no espaço que resta, é decodificada direto no buffer de saída;
+ * só o que fica a meio passa por 'pending'. Devolve 0 apenas depois do rodapé.
+ */
+static size_t preencherChunkHistorico(HistoricoExport& st, uint8_t* buffer, size_t maxLen) {
+    char* out = (char*)buffer;
+    size_t written = 0;
+
+    while (written < maxLen) {
+        if (st.pendingPos < st.pendingLen) {
+            size_t n = std::min(st.pendingLen - st.pendingPos, maxLen - written);
+            memcpy(out + written, st.pending + st.pendingPos, n);
+            st.pendingPos += n;
+            written += n;
+            continue;
+        }
+        st.pendingLen = 0;
+        st.pendingPos = 0;
+
+        if (st.stage == HistoricoExport::HEADER) {
+            int n = snprintf(st.pending, sizeof(st.pending),
+                             "{\"pagina_atual\":%d,\"total_arquivos\":%d,\"arquivo\":\"%s\",\"tamanho\":%u,\"linhas\":[",
+                             st.page, st.totalArquivos, st.arquivo.c_str(), (unsigned)st.fileSize);
+            st.pendingLen = std::min((size_t)std::max(n, 0), sizeof(st.pending) - 1);
+            st.stage = HistoricoExport::LINES;
+
+        } else if (st.stage == HistoricoExport::LINES) {
+            size_t sep = st.lineCount > 0 ? 1 : 0;
+            bool direct = (maxLen - written) >= sep + LOG_LINE_MAX;
+            char* dst = direct ? out + written : st.pending;
+
+            size_t len;
+            {
+                LogReadLock lock; // corre na tarefa do AsyncTCP: não lê o ficheiro do dia a meio de uma escrita
+                len = st.reader.readNextLine(dst + sep, LOG_LINE_MAX);
             }
-            
-            // Último chunk: fecha o JSON
-            if (inLinesArray && !currentFile.available()) {
-                String footer = "],\"total_linhas\":" + String(lineCount) + 
-                               ",\"proxima_pagina\":" + String((page < totalArquivos) ? page + 1 : 0) + 
-                               ",\"pagina_anterior\":" + String((page > 1) ? page - 1 : 0) + "}";
-                currentFile.close();
-                inLinesArray = false;
-                
-                if (footer.length() <= maxLen) {
-                    memcpy(buffer, footer.c_str(), footer.length());
-                    return footer.length();
-                }
+            if (len == 0) {
+                st.reader.close();
+                st.stage = HistoricoExport::FOOTER;
+                continue;
+            }
+            st.lineCount++;
+
+            if (dst[sep] != '{') {
+                // Linha que não é JSON: vai como string escapada
+                String escaped = "\"" + escapeJSON(String(dst + sep)) + "\"";
+                if (sep) st.pending[0] = ',';
+                size_t n = std::min((size_t)escaped.length(), sizeof(st.pending) - sep);
+                memcpy(st.pending + sep, escaped.c_str(), n);
+                st.pendingLen = sep + n;
+                continue;
             }
-            
-            return 0;
+
+            if (sep) dst[0] = ',';
+            if (direct) written += sep + len;
+            else st.pendingLen = sep + len;
+
+        } else if (st.stage == HistoricoExport::FOOTER) {
+            int n = snprintf(st.pending, sizeof(st.pending),
+                             "],\"total_linhas\":%d,\"proxima_pagina\":%d,\"pagina_anterior\":%d}",
+                             st.lineCount,
+                             (st.page < st.totalArquivos) ? st.page + 1 : 0,
+                             (st.page > 1) ? st.page - 1 : 0);
+            st.pendingLen = std::min((size_t)std::max(n, 0), sizeof(st.pending) - 1);
+            st.stage = HistoricoExport::DONE;
+
+        } else {
+            break;
+        }
+    }
+    return written;
+}
+
+void enviarArquivoInteiro(AsyncWebServerRequest *request, const String& arquivo, int page, int totalArquivos, time_t since, time_t until) {
+    std::shared_ptr<HistoricoExport> state = std::make_shared<HistoricoExport>();
+
+    if (!state->reader.open(arquivo)) {
+        request->send(404, "application/json", "{\"erro\":\"Arquivo não encontrado\"}");
+        return;
+    }
+    state->reader.setTimeRange(since, until); // salta pelo índice até 'since'
+
+    // A página depende do ficheiro, da paginação e do intervalo pedido
+    char suffix[48];
+    snprintf(suffix, sizeof(suffix), "-%d-%d-%lx-%lx", page, totalArquivos, (unsigned long)since, (unsigned long)until);
+    String etag = logFileETag(state->reader.size(), state->reader.lastWrite(), suffix);
+    if (etagMatches(request, etag)) {
+        enviarNaoModificado(request, etag);
+        return;
+    }
+
+    state->arquivo = arquivo;
+    state->page = page;
+    state->totalArquivos = totalArquivos;
+    state->fileSize = state->reader.size();
+    state->lineCount = 0;
+    state->stage = HistoricoExport::HEADER;
+    state->pendingLen = 0;
+    state->pendingPos = 0;
+
+    Serial.printf("Enviando arquivo completo: %s, Tamanho: %u bytes\n", arquivo.c_str(), (unsigned)state->fileSize);
+
+    AsyncWebServerResponse *response = request->beginChunkedResponse("application/json",
+        [state](uint8_t *buffer, size_t maxLen, size_t /*index*/) -> size_t {
+            return preencherChunkHistorico(*state, buffer, maxLen);
         }
     );
-    
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", "no-cache");
     request->send(response);
 }
 
@@ -168,68 +448,53 @@ String getFileNameFromPath(const String& path) {
 }
 
 
-void enviarArquivoPorPagina(AsyncWebServerRequest *request, int page) {
-    std::vector<String> arquivos;
-    
-    File root = LittleFS.open("/logs");
-    if (root && root.isDirectory()) {
-        File dir = root.openNextFile();
-        while (dir) {
-            if (dir.isDirectory()) {
-                String dirName = dir.name();
-                String fullDirPath = "/logs/" + dirName;
-                
-                File subDir = LittleFS.open(fullDirPath);
-                if (subDir && subDir.isDirectory()) {
-                    File file = subDir.openNextFile();
-                    while (file) {
-                        if (!file.isDirectory() && String(file.name()).endsWith(".jsonl")) {
-                            String filename = getFileNameFromPath(file.name());
-                            String fullFilePath = fullDirPath + "/" + filename;
-                            arquivos.push_back(fullFilePath);
-                        }
-                        file = subDir.openNextFile();
-                    }
-                    subDir.close();
-                }
-            }
-            dir = root.openNextFile();
-        }
-        root.close();
+// Arquivo da página do catálogo, do mais recente (página 1) para o mais antigo.
+// Sem intervalo o acesso é direto; com since/until só entram os arquivos que o tocam.
+static bool arquivoDaPagina(int page, time_t since, time_t until, String& arquivo, int& totalArquivos) {
+    LogCatalogEntry entry;
+    bool found;
+    if (since == 0 && until == 0) {
+        totalArquivos = getLogCatalogSize();
+        found = page >= 1 && page <= totalArquivos && getLogCatalogEntry(totalArquivos - page, entry);
+    } else {
+        std::vector<LogCatalogEntry> entries = findLogCatalogEntries(String(), since, until);
+        totalArquivos = entries.size();
+        found = page >= 1 && page <= totalArquivos;
+        if (found) entry = entries[totalArquivos - page];
     }
+    if (found) arquivo = logCatalogPath(entry);
+    return found;
+}
 
-    // DEBUG: Mostrar quantos arquivos foram encontrados e quais são
-    Serial.printf("Total de arquivos encontrados: %d\n", arquivos.size());
-    Serial.printf("Página solicitada: %d\n", page);
-    
-    for (int i = 0; i < arquivos.size(); i++) {
-        Serial.printf("Arquivo %d: %s\n", i + 1, arquivos[i].c_str());
-    }
+static void enviarPaginaInexistente(AsyncWebServerRequest *request, int page, int totalArquivos) {
+    Serial.printf("ERRO: Página %d não existe. Total: %d\n", page, totalArquivos);
+    DynamicJsonDocument doc(512);
+    doc["erro"] = "Página não encontrada";
+    doc["total_arquivos"] = totalArquivos;
+    doc["paginas_disponiveis"] = (totalArquivos > 0) ? "1 a " + String(totalArquivos) : "Nenhum arquivo";
 
-    // Ordena por nome (mais recente primeiro)
-    std::sort(arquivos.begin(), arquivos.end(), std::greater<String>());
+    String response;
+    serializeJson(doc, response);
+    request->send(404, "application/json", response);
+}
 
-    int totalArquivos = arquivos.size();
+void enviarArquivoPorPagina(AsyncWebServerRequest *request, int page, time_t since, time_t until) {
+    // Grava o buffer de escrita para o arquivo do dia sair completo
+    flushLogs();
+
+    String arquivo;
+    int totalArquivos = 0;
+    bool found = arquivoDaPagina(page, since, until, arquivo, totalArquivos);
+    Serial.printf("Total de arquivos: %d, página solicitada: %d\n", totalArquivos, page);
 
     // Verifica se a página existe
-    if (page < 1 || page > totalArquivos) {
-        Serial.printf("ERRO: Página %d não existe. Total: %d\n", page, totalArquivos);
-        DynamicJsonDocument doc(512);
-        doc["erro"] = "Página não encontrada";
-        doc["total_arquivos"] = totalArquivos;
-        doc["paginas_disponiveis"] = (totalArquivos > 0) ? "1 a " + String(totalArquivos) : "Nenhum arquivo";
-        
-        String response;
-        serializeJson(doc, response);
-        request->send(404, "application/json", response);
+    if (!found) {
+        enviarPaginaInexistente(request, page, totalArquivos);
         return;
     }
 
-    // Pega o arquivo correspondente à página
-    String arquivo = arquivos[page - 1];
     Serial.printf("Enviando arquivo da página %d: %s\n", page, arquivo.c_str());
-    
-    enviarArquivoInteiro(request, arquivo, page, totalArquivos);
+    enviarArquivoInteiro(request, arquivo, page, totalArquivos, since, until);
 }
 void setupWiFi(DeviceController& meuDevice) {
     Serial.println("Configurando modo Access Point (AP)...");
@@ -300,17 +565,85 @@ server.on("/limpar_historico", HTTP_GET, [](AsyncWebServerRequest *request){
 
 
 
+// Ferramenta de reparo: reconta todos os ficheiros e corrige o manifesto de contagem.
+// Registado antes de "/historico", que também casaria com "/historico/...".
+server.on("/historico/verificar", HTTP_GET, [](AsyncWebServerRequest *request){
+    uint32_t manifesto = getTotalRecordCount();
+    uint32_t recontado = rebuildRecordManifest();
+
+    StaticJsonDocument<128> doc;
+    doc["manifesto"] = manifesto;
+    doc["recontado"] = recontado;
+    doc["reparado"] = (manifesto != recontado);
+
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+});
+
+// Ficheiro de log sem conversão, com ETag (If-None-Match -> 304) e Range (206).
+// Escolhido por caminho (como em /info/info) ou pela mesma página do /historico.
+server.on("/historico/arquivo", HTTP_GET, [](AsyncWebServerRequest *request){
+    String arquivo;
+    if (request->hasParam("caminho")) {
+        arquivo = request->getParam("caminho")->value();
+        // Só ficheiros de log dentro de /logs
+        if (!arquivo.startsWith(String(LOG_DIR) + "/") || arquivo.indexOf("..") != -1 || !isLogFileName(arquivo)) {
+            request->send(400, "application/json", "{\"erro\":\"Caminho inválido\"}");
+            return;
+        }
+    } else {
+        int page = request->hasParam("page") ? request->getParam("page")->value().toInt() : 1;
+        int totalArquivos = 0;
+        if (!arquivoDaPagina(page, 0, 0, arquivo, totalArquivos)) {
+            enviarPaginaInexistente(request, page, totalArquivos);
+            return;
+        }
+    }
+    enviarArquivoBruto(request, arquivo);
+});
+
+// Histórico completo num único array JSON, com cursor próprio do pedido.
+// Filtros opcionais: sensor=<id>, since/until em epoch (segundos).
+server.on("/historico/stream", HTTP_GET, [](AsyncWebServerRequest *request){
+    String sensorId = request->hasParam("sensor") ? request->getParam("sensor")->value() : String();
+    time_t since = request->hasParam("since") ? request->getParam("since")->value().toInt() : 0;
+    time_t until = request->hasParam("until") ? request->getParam("until")->value().toInt() : 0;
+
+    std::shared_ptr<LogStreamCursor> cursor = std::make_shared<LogStreamCursor>();
+    cursor->begin(sensorId, since, until);
+    Serial.printf("Requisição para /historico/stream: %u arquivo(s)\n", (unsigned)cursor->fileCount());
+
+    AsyncWebServerResponse *response = request->beginChunkedResponse("application/json",
+        [cursor](uint8_t *buffer, size_t maxLen, size_t /*index*/) -> size_t {
+            return cursor->read(buffer, maxLen);
+        }
+    );
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+});
+
 server.on("/historico", HTTP_GET, [](AsyncWebServerRequest *request){
     int page = 1;
     
+    time_t since = 0;
+    time_t until = 0;
+    
     if (request->hasParam("page")) {
         page = request->getParam("page")->value().toInt();
     }
+    // Intervalo opcional em epoch (segundos)
+    if (request->hasParam("since")) {
+        since = request->getParam("since")->value().toInt();
+    }
+    if (request->hasParam("until")) {
+        until = request->getParam("until")->value().toInt();
+    }
 
     Serial.printf("Requisição para /historico. Página: %d\n", page);
 
     // Envia o arquivo correspondente à página
-    enviarArquivoPorPagina(request, page);
+    enviarArquivoPorPagina(request, page, since, until);
 });
 
 
@@ -426,41 +759,26 @@ server.on("/historico", HTTP_GET, [](AsyncWebServerRequest *request) {
 
 
 server.on("/info/info", HTTP_GET, [](AsyncWebServerRequest *request){
-    DynamicJsonDocument doc(2048);
-    JsonArray arquivos = doc.to<JsonArray>();
-    int totalArquivos = 0;
+    // Catálogo em RAM: nenhuma leitura do sistema de arquivos
+    std::vector<LogCatalogEntry> entries = findLogCatalogEntries(String(), 0, 0);
+    int totalArquivos = entries.size();
 
-    File root = LittleFS.open("/logs");
-    if (root && root.isDirectory()) {
-        File dir = root.openNextFile();
-        while (dir) {
-            if (dir.isDirectory()) {
-                String dirName = dir.name();
-                String fullDirPath = "/logs/" + dirName;
-                
-                File subDir = LittleFS.open(fullDirPath);
-                if (subDir && subDir.isDirectory()) {
-                    File file = subDir.openNextFile();
-                    while (file) {
-                        if (!file.isDirectory() && String(file.name()).endsWith(".jsonl")) {
-                            String filename = getFileNameFromPath(file.name());
-                            String fullFilePath = fullDirPath + "/" + filename;
-                            
-                            JsonObject arquivoInfo = arquivos.createNestedObject();
-                            arquivoInfo["pagina"] = ++totalArquivos;
-                            arquivoInfo["nome"] = filename;
-                            arquivoInfo["caminho"] = fullFilePath;
-                            arquivoInfo["tamanho"] = file.size();
-                            arquivoInfo["modificado"] = file.getLastWrite();
-                        }
-                        file = subDir.openNextFile();
-                    }
-                    subDir.close();
-                }
-            }
-            dir = root.openNextFile();
+    DynamicJsonDocument doc(1024 + entries.size() * (JSON_OBJECT_SIZE(8) + 64));
+    JsonArray arquivos = doc.to<JsonArray>();
+    for (int i = 0; i < totalArquivos; i++) {
+        const LogCatalogEntry& entry = entries[i];
+        JsonObject arquivoInfo = arquivos.createNestedObject();
+        arquivoInfo["pagina"] = totalArquivos - i; // mesma numeração do /historico
+        arquivoInfo["nome"] = logCatalogFileName(entry);
+        arquivoInfo["caminho"] = logCatalogPath(entry);
+        arquivoInfo["tamanho"] = entry.bytes;
+        arquivoInfo["registros"] = entry.records;
+        arquivoInfo["modificado"] = entry.modified; // mtime do ficheiro, como antes do catálogo
+        // "tamanho" é o do .gz/.col no flash
+        arquivoInfo["comprimido"] = entry.compression != LogCompression::NONE;
+        if (entry.compression != LogCompression::NONE) {
+            arquivoInfo["codificacao"] = entry.compression == LogCompression::COLUMNAR ? "colunar" : "gzip";
         }
-        root.close();
     }
 
     doc["total_arquivos"] = totalArquivos;
@@ -508,6 +826,50 @@ server.on("/info/info", HTTP_GET, [](AsyncWebServerRequest *request){
   });
 
 
+    // Amostras recentes servidas da RAM (buffer circular de cada sensor), sem ler o flash
+    server.on("/recentes", HTTP_GET, [&meuDevice](AsyncWebServerRequest *request){
+        String sensorId = request->hasParam("sensor") ? request->getParam("sensor")->value() : String();
+        size_t lastN = request->hasParam("n") ? request->getParam("n")->value().toInt() : 0;
+        time_t since = request->hasParam("since") ? request->getParam("since")->value().toInt() : 0;
+
+        size_t sensorCount = sensorId.length() > 0 ? 1 : meuDevice.getSensors().size();
+        DynamicJsonDocument doc(JSON_OBJECT_SIZE(1) + JSON_ARRAY_SIZE(sensorCount) +
+                                sensorCount * (JSON_OBJECT_SIZE(3) + JSON_ARRAY_SIZE(SENSOR_RING_CAPACITY) +
+                                               SENSOR_RING_CAPACITY * JSON_ARRAY_SIZE(3)));
+        JsonArray sensorsArray = doc.createNestedArray("sensors");
+        if (!meuDevice.recentSamplesToJson(sensorsArray, sensorId, lastN, since)) {
+            request->send(404, "application/json", "{\"erro\":\"Sensor não encontrado\"}");
+            return;
+        }
+
+        String output;
+        serializeJson(doc, output);
+        request->send(200, "application/json", output);
+    });
+
+    // Agregados por janela: ficheiros diários em /rollups mais a janela aberta de cada sensor
+    server.on("/agregados", HTTP_GET, [&meuDevice](AsyncWebServerRequest *request){
+        String sensorId = request->hasParam("sensor") ? request->getParam("sensor")->value() : String();
+        uint32_t window = request->hasParam("window") ? request->getParam("window")->value().toInt() : 0;
+        time_t since = request->hasParam("since") ? request->getParam("since")->value().toInt() : 0;
+        time_t until = request->hasParam("until") ? request->getParam("until")->value().toInt() : 0;
+        size_t limit = request->hasParam("limit") ? request->getParam("limit")->value().toInt() : ROLLUPS_PER_PAGE;
+        if (limit == 0 || limit > ROLLUPS_MAX_PAGE) limit = ROLLUPS_MAX_PAGE;
+
+        DynamicJsonDocument doc(JSON_OBJECT_SIZE(2) + meuDevice.rollupsJsonCapacity(limit));
+        JsonArray sensorsArray = doc.createNestedArray("sensors");
+        time_t next = 0;
+        if (!meuDevice.rollupsToJson(sensorsArray, sensorId, window, since, until, limit, next)) {
+            request->send(404, "application/json", "{\"erro\":\"Sensor não encontrado\"}");
+            return;
+        }
+        if (next != 0) doc["next"] = (uint32_t)next; // since da página seguinte
+
+        String output;
+        serializeJson(doc, output);
+        request->send(200, "application/json", output);
+    });
+
     server.begin();
     Serial.println("Servidor Web iniciado.");
 }